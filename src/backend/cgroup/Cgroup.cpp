@@ -0,0 +1,250 @@
+#include "Cgroup.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../../utils/FieldParser.hpp"
+#include "../process/ProcFiles.hpp"
+
+namespace backend::cgroup {
+
+const std::array<const char*, Cgroup::FileCount> Cgroup::_FileNames{"cpu.stat", "memory.current", "memory.stat",
+                                                                   "io.stat", "cgroup.events"};
+
+const std::array<Cgroup::Key, 6> Cgroup::_CpuStatKeys{{
+    {"usage_usec", Field::CpuUsage},
+    {"user_usec", Field::CpuUser},
+    {"system_usec", Field::CpuSystem},
+    {"nr_periods", Field::CpuPeriods},
+    {"nr_throttled", Field::CpuThrottled},
+    {"throttled_usec", Field::CpuThrottledTime},
+}};
+
+const std::array<Cgroup::Key, 5> Cgroup::_MemoryStatKeys{{
+    {"anon", Field::MemoryAnon},
+    {"file", Field::MemoryFile},
+    {"shmem", Field::MemoryShmem},
+    {"kernel", Field::MemoryKernel},
+    {"sock", Field::MemorySock},
+}};
+
+const std::array<Cgroup::Key, 4> Cgroup::_IoStatKeys{{
+    {"rbytes", Field::IoReadBytes},
+    {"wbytes", Field::IoWriteBytes},
+    {"rios", Field::IoReads},
+    {"wios", Field::IoWrites},
+}};
+
+Cgroup::Cgroup(std::shared_ptr<utils::FileHandle> root, std::string path, std::weak_ptr<Cgroup> parent)
+    : _Root(root), _Path(std::move(path)), _Parent(parent), _CreateTime(std::chrono::steady_clock::now()),
+      _LastUpdate(_CreateTime) {
+  if (!_Path.empty()) {
+    UpdateEvents();
+  }
+}
+
+Cgroup::~Cgroup() {
+  size_t count = std::ranges::count_if(_Files, [](auto& fd) { return fd.has_value(); }) +
+                 std::ranges::count_if(_Pressure, [](auto& pressure) { return pressure != nullptr; });
+  process::ProcFileBudget::GetInstance().Refund(count);
+}
+
+std::string_view Cgroup::GetName() const {
+  std::string_view path(_Path);
+  return path.substr(path.rfind('/') + 1);
+}
+
+std::shared_ptr<metrics::Gauge> Cgroup::GetGauge(std::shared_ptr<Cgroup> me, Field field) {
+  auto& gauge = me->_Gauges[static_cast<size_t>(field)];
+  if (auto result = gauge.lock()) {
+    return result;
+  } else {
+    result = std::make_shared<CgroupGauge>(me);
+    gauge = result;
+    // Read right away: counters must not start from 0, a rate over them would begin with a spike.
+    me->Update();
+    return result;
+  }
+}
+
+std::shared_ptr<system::Pressure> Cgroup::GetPressure(system::Pressure::Resource resource) {
+  auto& pressure = _Pressure[static_cast<size_t>(resource)];
+  if (!pressure) {
+    int fd = OpenAt(system::Pressure::GetCgroupFileName(resource), O_RDONLY);
+    if (fd < 0) {
+      return nullptr;
+    }
+    pressure = std::make_shared<system::Pressure>(resource, fd);
+    process::ProcFileBudget::GetInstance().Charge(1);
+  }
+  return pressure;
+}
+
+int Cgroup::OpenAt(const std::string& name, int flags) const {
+  return openat(*_Root, _Path.empty() ? name.c_str() : (_Path + "/" + name).c_str(), flags | O_CLOEXEC);
+}
+
+bool Cgroup::IsWatched() const {
+  return std::ranges::any_of(_Gauges, [](auto& gauge) { return !gauge.expired(); }) ||
+         std::ranges::any_of(_Pressure, [](auto& pressure) { return pressure && pressure->IsWatched(); });
+}
+
+void Cgroup::Update() {
+  _LastUpdate = std::chrono::steady_clock::now();
+
+  if (Wants(_CpuStatKeys)) {
+    ParseFlatKeyed(File::CpuStat, _CpuStatKeys);
+  }
+
+  if (Wants(Field::MemoryCurrent)) {
+    std::array<char, 32> buffer;
+    metrics::DataType value;
+    if (ssize_t size = Read(File::MemoryCurrent, buffer);
+        size > 0 && std::from_chars(buffer.data(), buffer.data() + size, value).ec == std::errc()) {
+      Set(Field::MemoryCurrent, value);
+    }
+  }
+
+  if (Wants(_MemoryStatKeys)) {
+    ParseFlatKeyed(File::MemoryStat, _MemoryStatKeys);
+  }
+
+  if (Wants(_IoStatKeys)) {
+    ParseIoStat();
+  }
+
+  for (auto& pressure : _Pressure) {
+    if (pressure && pressure->IsWatched()) {
+      pressure->Update();
+    }
+  }
+}
+
+void Cgroup::CloseUnwatched() {
+  size_t count = 0;
+  if (std::ranges::none_of(_Gauges, [](auto& gauge) { return !gauge.expired(); })) {
+    for (auto& fd : _Files) {
+      count += fd.has_value();
+      fd.reset();
+    }
+  }
+  for (auto& pressure : _Pressure) {
+    // Only this cgroup holds it then, the descriptor goes with it.
+    if (pressure && !pressure->IsWatched()) {
+      pressure.reset();
+      ++count;
+    }
+  }
+  if (count > 0) {
+    process::ProcFileBudget::GetInstance().Refund(count);
+  }
+}
+
+void Cgroup::UpdateEvents() {
+  std::array<char, 128> buffer;
+  ssize_t size = Read(File::Events, buffer);
+  if (size <= 0) {
+    return;
+  }
+
+  utils::FieldParser parser({buffer.data(), static_cast<size_t>(size)});
+  std::string_view key;
+  int value;
+  while (parser.Next(key) && parser.Next(value)) {
+    if (key == "populated") {
+      _Populated = value != 0;
+    }
+  }
+}
+
+bool Cgroup::Wants(std::span<const Key> keys) const {
+  return std::ranges::any_of(keys, [this](const Key& key) { return Wants(key.Target); });
+}
+
+ssize_t Cgroup::Read(File file, std::span<char> buffer) {
+  auto index = static_cast<size_t>(file);
+  if (_Missing[index]) {
+    return -1;
+  }
+
+  if (_Files[index]) {
+    return pread(*_Files[index], buffer.data(), buffer.size(), 0);
+  }
+
+  int fd = OpenAt(_FileNames[index], O_RDONLY);
+  if (fd < 0) {
+    // ENOENT when the controller is not enabled here, the cgroup being removed is noticed through inotify. Anything
+    // else, e.g. EMFILE, is retried on the next read.
+    _Missing[index] = errno == ENOENT;
+    return -1;
+  }
+
+  if (file == File::Events) {
+    // Read by every cgroup, but rarely: not worth a descriptor each.
+    utils::FileHandle handle(fd);
+    return pread(fd, buffer.data(), buffer.size(), 0);
+  }
+  _Files[index].emplace(fd);
+  process::ProcFileBudget::GetInstance().Charge(1);
+  return pread(fd, buffer.data(), buffer.size(), 0);
+}
+
+void Cgroup::Set(Field field, metrics::DataType value) {
+  auto index = static_cast<size_t>(field);
+  _Values[index] = value;
+  if (auto ptr = _Gauges[index].lock()) {
+    ptr->SetValue(value);
+  }
+}
+
+void Cgroup::ParseFlatKeyed(File file, std::span<const Key> keys) {
+  // memory.stat is a few KiB on recent kernels.
+  std::array<char, 8192> buffer;
+  ssize_t size = Read(file, buffer);
+  if (size <= 0) {
+    return;
+  }
+
+  utils::FieldParser parser({buffer.data(), static_cast<size_t>(size)});
+  std::string_view key;
+  metrics::DataType value;
+  while (parser.Next(key) && parser.Next(value)) {
+    if (auto match = std::ranges::find(keys, key, &Key::Name); match != keys.end()) {
+      Set(match->Target, value);
+    }
+  }
+}
+
+void Cgroup::ParseIoStat() {
+  // One line per device: "MAJ:MIN rbytes=... wbytes=... rios=... wios=... dbytes=... dios=...".
+  std::array<char, 8192> buffer;
+  ssize_t size = Read(File::IoStat, buffer);
+  if (size < 0) {
+    return;
+  }
+
+  std::array<metrics::DataType, _IoStatKeys.size()> sums{};
+  utils::FieldParser parser({buffer.data(), static_cast<size_t>(size)});
+  std::string_view word;
+  while (parser.Next(word)) {
+    auto equals = word.find('=');
+    if (equals == std::string_view::npos) {
+      continue;
+    }
+
+    auto match = std::ranges::find(_IoStatKeys, word.substr(0, equals), &Key::Name);
+    metrics::DataType value;
+    if (match != _IoStatKeys.end() &&
+        std::from_chars(word.data() + equals + 1, word.data() + word.size(), value).ec == std::errc()) {
+      sums[match - _IoStatKeys.begin()] += value;
+    }
+  }
+
+  for (size_t i = 0; i < _IoStatKeys.size(); ++i) {
+    Set(_IoStatKeys[i].Target, sums[i]);
+  }
+}
+
+} // namespace backend::cgroup
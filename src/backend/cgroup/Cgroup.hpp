@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "../../utils/Error.hpp"
+#include "../metrics/Gauge.hpp"
+#include "../system/Pressure.hpp"
+
+namespace backend::cgroup {
+
+// One cgroup v2 directory. Statistics are read only for fields somebody holds a gauge of. Files are opened by path
+// below the hierarchy root and kept open only while watched, so there may be thousands of cgroups; the descriptors are
+// charged to the ProcFileBudget.
+class Cgroup {
+public:
+  // `root` is the opened hierarchy root, `path` is relative to it, empty for the root itself.
+  explicit Cgroup(std::shared_ptr<utils::FileHandle> root, std::string path, std::weak_ptr<Cgroup> parent);
+  ~Cgroup();
+
+  Cgroup(const Cgroup&) = delete;
+  Cgroup(Cgroup&&) = delete;
+  Cgroup& operator=(const Cgroup&) = delete;
+  Cgroup& operator=(Cgroup&&) = delete;
+
+  // Fields of cpu.stat (usec or counts), memory.current and memory.stat (bytes), and io.stat summed over all devices
+  // (bytes or operations). All but MemoryCurrent and the memory.stat sizes are counters.
+  enum class Field {
+    CpuUsage,
+    CpuUser,
+    CpuSystem,
+    CpuPeriods,
+    CpuThrottled,
+    CpuThrottledTime,
+    MemoryCurrent,
+    MemoryAnon,
+    MemoryFile,
+    MemoryShmem,
+    MemoryKernel,
+    MemorySock,
+    IoReadBytes,
+    IoWriteBytes,
+    IoReads,
+    IoWrites,
+    Count
+  };
+
+  using GaugePtr = std::shared_ptr<metrics::Gauge>;
+  static GaugePtr GetGauge(std::shared_ptr<Cgroup> me, Field field);
+  // The <resource>.pressure of this cgroup, refreshed by Update while any of its gauges is held. nullptr when the
+  // kernel has no PSI.
+  std::shared_ptr<system::Pressure> GetPressure(system::Pressure::Resource resource);
+
+  const std::string& GetPath() const { return _Path; }
+  std::string_view GetName() const;
+  std::shared_ptr<Cgroup> GetParent() const { return _Parent.lock(); }
+  const std::map<std::string, std::shared_ptr<Cgroup>, std::less<>>& GetChildren() const { return _Children; }
+  // Opens `name` in the directory of this cgroup, "." for the directory itself. Returns -1 with errno set on failure.
+  int OpenAt(const std::string& name, int flags) const;
+
+  // Whether any process lives in this cgroup or below, from cgroup.events. The root is always populated.
+  bool IsPopulated() const { return _Populated; }
+  bool IsWatched() const;
+
+  // Reads the files backing the watched fields.
+  void Update();
+  // Rereads cgroup.events.
+  void UpdateEvents();
+  // Closes the files and pressure nobody holds a gauge of any more.
+  void CloseUnwatched();
+
+private:
+  friend class CgroupTree;
+
+  class CgroupGauge : public metrics::Gauge {
+  public:
+    explicit CgroupGauge(std::shared_ptr<Cgroup> owner) : _Owner(owner) {}
+
+    void SetValue(metrics::DataType value) {
+      _Value = value;
+      _First = false;
+      Notify();
+    }
+
+    std::chrono::steady_clock::time_point GetLastUpdate() const override {
+      return _First ? _Owner->_CreateTime : _Owner->_LastUpdate;
+    }
+    metrics::DataType GetValue() const override { return _Value; }
+
+  private:
+    std::shared_ptr<Cgroup> _Owner;
+    metrics::DataType _Value = 0;
+    bool _First = true;
+  };
+
+  enum class File { CpuStat, MemoryCurrent, MemoryStat, IoStat, Events, Count };
+  static constexpr size_t FileCount = static_cast<size_t>(File::Count);
+  static constexpr size_t FieldCount = static_cast<size_t>(Field::Count);
+
+  // Maps the keys of the flat keyed files to fields.
+  struct Key {
+    std::string_view Name;
+    Field Target;
+  };
+  static const std::array<const char*, FileCount> _FileNames;
+  static const std::array<Key, 6> _CpuStatKeys;
+  static const std::array<Key, 5> _MemoryStatKeys;
+  static const std::array<Key, 4> _IoStatKeys;
+
+  bool Wants(std::span<const Key> keys) const;
+  bool Wants(Field field) const { return !_Gauges[static_cast<size_t>(field)].expired(); }
+  ssize_t Read(File file, std::span<char> buffer);
+  void Set(Field field, metrics::DataType value);
+  void ParseFlatKeyed(File file, std::span<const Key> keys);
+  void ParseIoStat();
+
+  const std::shared_ptr<utils::FileHandle> _Root;
+  const std::string _Path;
+  const std::weak_ptr<Cgroup> _Parent;
+  std::map<std::string, std::shared_ptr<Cgroup>, std::less<>> _Children;
+
+  std::array<std::optional<utils::FileHandle>, FileCount> _Files;
+  // Files not provided by this cgroup, e.g. because the controller is not enabled.
+  std::array<bool, FileCount> _Missing{};
+
+  std::array<std::weak_ptr<CgroupGauge>, FieldCount> _Gauges;
+  std::array<std::shared_ptr<system::Pressure>, static_cast<size_t>(system::Pressure::Resource::Count)> _Pressure;
+  std::array<metrics::DataType, FieldCount> _Values{};
+  std::chrono::steady_clock::time_point _CreateTime;
+  std::chrono::steady_clock::time_point _LastUpdate;
+  bool _Populated = true;
+};
+
+} // namespace backend::cgroup
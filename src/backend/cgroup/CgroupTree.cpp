@@ -0,0 +1,271 @@
+#include "CgroupTree.hpp"
+
+#include <array>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/magic.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace backend::cgroup {
+
+namespace {
+
+// Calls `callback(name)` for every subdirectory of `cgroup`. Returns false when the directory can't be opened, e.g.
+// because the cgroup was just removed, or out of descriptors.
+template <typename F> bool ForEachDirectory(const Cgroup& cgroup, F&& callback) {
+  int dirFd = cgroup.OpenAt(".", O_RDONLY | O_DIRECTORY);
+  if (dirFd < 0) {
+    return false;
+  }
+  utils::FileHandle fd(dirFd);
+  alignas(struct dirent64) std::array<char, 8192> buffer;
+  while (true) {
+    long size = syscall(SYS_getdents64, dirFd, buffer.data(), buffer.size());
+    if (size <= 0) {
+      return true;
+    }
+    for (long offset = 0; offset < size;) {
+      auto* entry = reinterpret_cast<struct dirent64*>(buffer.data() + offset);
+      offset += entry->d_reclen;
+      std::string_view name(entry->d_name);
+      if (entry->d_type == DT_DIR && name != "." && name != "..") {
+        callback(name);
+      }
+    }
+  }
+}
+
+} // namespace
+
+CgroupTree::CgroupTree(std::string root)
+    : _RootPath(std::move(root)),
+      _RootFd(std::make_shared<utils::FileHandle>(PosixE(open(_RootPath.c_str(), O_PATH | O_DIRECTORY | O_CLOEXEC)))),
+      _Root(std::make_shared<Cgroup>(_RootFd, "", std::weak_ptr<Cgroup>())) {
+  struct statfs fs;
+  PosixE(fstatfs(*_RootFd, &fs));
+  if (fs.f_type != CGROUP2_SUPER_MAGIC) {
+    throw std::system_error(ENOTSUP, std::generic_category());
+  }
+
+  Walk(_Root);
+}
+
+void CgroupTree::Walk(std::shared_ptr<Cgroup> cgroup) {
+  ForEachDirectory(*cgroup, [&](std::string_view name) { AddChild(cgroup, name); });
+}
+
+void CgroupTree::AddChild(std::shared_ptr<Cgroup> parent, std::string_view name) {
+  if (parent->_Children.contains(name)) {
+    return;
+  }
+
+  std::string path = parent->GetPath().empty() ? std::string(name) : parent->GetPath() + "/" + std::string(name);
+  if (struct stat st; fstatat(*_RootFd, path.c_str(), &st, AT_SYMLINK_NOFOLLOW) < 0) {
+    // Removed again before we got to it.
+    return;
+  }
+
+  auto child = std::make_shared<Cgroup>(_RootFd, std::move(path), parent);
+  parent->_Children.emplace(name, child);
+  AddWatches(child);
+  Walk(child);
+}
+
+int CgroupTree::OpenWatcher() {
+  int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+  _NotifyFd = fd;
+
+  std::vector<std::shared_ptr<Cgroup>> all;
+  Flatten(all);
+  for (auto& cgroup : all) {
+    AddWatches(cgroup);
+  }
+
+  // Whatever was created or changed between the walk and the watches.
+  Rescan(_Root, true);
+  return fd;
+}
+
+void CgroupTree::AddWatches(std::shared_ptr<Cgroup> cgroup) {
+  if (_NotifyFd < 0) {
+    return;
+  }
+
+  std::string path = cgroup->GetPath().empty() ? _RootPath : _RootPath + "/" + cgroup->GetPath();
+
+  bool directory = false;
+  if (int wd = inotify_add_watch(_NotifyFd, path.c_str(), IN_CREATE | IN_DELETE | IN_ONLYDIR); wd >= 0) {
+    _Watches[wd] = {cgroup, WatchKind::Directory};
+    directory = true;
+  }
+  // The root has no cgroup.events, it is always populated.
+  bool events = cgroup->GetPath().empty();
+  if (!events) {
+    path += "/cgroup.events";
+    if (int wd = inotify_add_watch(_NotifyFd, path.c_str(), IN_MODIFY); wd >= 0) {
+      _Watches[wd] = {cgroup, WatchKind::Events};
+      events = true;
+    }
+  }
+
+  // Out of watches (fs.inotify.max_user_watches): PollUnwatched reads this cgroup on every Update instead.
+  if (!directory || !events) {
+    _Unwatched.push_back({cgroup, !directory, !events});
+  }
+}
+
+void CgroupTree::Rescan(std::shared_ptr<Cgroup> cgroup, bool recursive) {
+  std::map<std::string, std::shared_ptr<Cgroup>, std::less<>> present;
+  bool listed = ForEachDirectory(*cgroup, [&](std::string_view name) {
+    if (auto it = cgroup->_Children.find(name); it != cgroup->_Children.end()) {
+      UpdateEvents(it->second);
+      present.emplace(it->first, it->second);
+    } else {
+      AddChild(cgroup, name);
+      // Unless it was removed again already.
+      if (auto child = cgroup->_Children.find(name); child != cgroup->_Children.end()) {
+        present.emplace(child->first, child->second);
+      }
+    }
+  });
+  // Gone, which its parent learns, or out of descriptors: try again next time.
+  if (!listed) {
+    return;
+  }
+  cgroup->_Children = std::move(present);
+
+  if (recursive) {
+    for (auto& [name, child] : cgroup->_Children) {
+      Rescan(child, true);
+    }
+  }
+}
+
+void CgroupTree::UpdateEvents(std::shared_ptr<Cgroup> cgroup) {
+  bool populated = cgroup->IsPopulated();
+  cgroup->UpdateEvents();
+  if (populated && !cgroup->IsPopulated()) {
+    _Dirty.push_back(cgroup);
+  }
+}
+
+void CgroupTree::PollUnwatched() {
+  std::erase_if(_Unwatched, [](const Unwatched& unwatched) { return unwatched.Target.expired(); });
+  // Rescanning may add more.
+  for (size_t i = 0, size = _Unwatched.size(); i < size; ++i) {
+    auto [weak, directory, events] = _Unwatched[i];
+    auto cgroup = weak.lock();
+    if (!cgroup) {
+      continue;
+    }
+    if (events) {
+      UpdateEvents(cgroup);
+    }
+    if (directory) {
+      Rescan(cgroup, false);
+    }
+  }
+}
+
+void CgroupTree::Receive(int fd) {
+  alignas(struct inotify_event) std::array<char, 4096> buffer;
+  while (true) {
+    ssize_t size = read(fd, buffer.data(), buffer.size());
+    if (size < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN) {
+        return;
+      }
+      throw std::system_error(errno, std::generic_category());
+    }
+
+    for (ssize_t offset = 0; offset < size;) {
+      auto* event = reinterpret_cast<struct inotify_event*>(buffer.data() + offset);
+      offset += sizeof(struct inotify_event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        // Both directory and cgroup.events changes may have been lost.
+        Rescan(_Root, true);
+        continue;
+      }
+
+      auto it = _Watches.find(event->wd);
+      if (it == _Watches.end()) {
+        continue;
+      }
+      if (event->mask & IN_IGNORED) {
+        _Watches.erase(it);
+        continue;
+      }
+
+      auto target = it->second.Target.lock();
+      if (!target) {
+        continue;
+      }
+
+      if (it->second.Kind == WatchKind::Events) {
+        target->UpdateEvents();
+        _Dirty.push_back(target);
+      } else if (event->len > 0 && (event->mask & IN_ISDIR)) {
+        std::string_view name(event->name);
+        if (event->mask & IN_CREATE) {
+          AddChild(target, name);
+        } else if (event->mask & IN_DELETE) {
+          if (auto child = target->_Children.find(name); child != target->_Children.end()) {
+            target->_Children.erase(child);
+          }
+        }
+      }
+    }
+  }
+}
+
+void CgroupTree::Update() {
+  if (_NotifyFd < 0) {
+    Rescan(_Root, true);
+  } else {
+    PollUnwatched();
+  }
+
+  for (auto& weak : _Dirty) {
+    if (auto cgroup = weak.lock(); cgroup && !cgroup->IsPopulated() && cgroup->IsWatched()) {
+      // Its last processes just left, take the final values.
+      cgroup->Update();
+    }
+  }
+  _Dirty.clear();
+
+  Update(*_Root);
+}
+
+void CgroupTree::Update(Cgroup& cgroup) {
+  // Scrolled off screen, give the descriptors back.
+  cgroup.CloseUnwatched();
+  // Nothing can change in an empty cgroup.
+  if (cgroup.IsPopulated() && cgroup.IsWatched()) {
+    cgroup.Update();
+  }
+  for (auto& [name, child] : cgroup._Children) {
+    Update(*child);
+  }
+}
+
+void CgroupTree::Flatten(std::vector<std::shared_ptr<Cgroup>>& result) const { Flatten(_Root, result); }
+
+void CgroupTree::Flatten(const std::shared_ptr<Cgroup>& cgroup, std::vector<std::shared_ptr<Cgroup>>& result) {
+  result.push_back(cgroup);
+  for (auto& [name, child] : cgroup->GetChildren()) {
+    Flatten(child, result);
+  }
+}
+
+} // namespace backend::cgroup
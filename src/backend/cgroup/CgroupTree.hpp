@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Cgroup.hpp"
+
+namespace backend::cgroup {
+
+// The cgroup v2 hierarchy. It is walked once; afterwards cgroups appearing and disappearing, and cgroups becoming
+// (un)populated, are learned from inotify. Unpopulated cgroups don't change, so they are only read again after their
+// cgroup.events changed. Cgroups inotify can't watch, e.g. beyond fs.inotify.max_user_watches, are polled instead.
+class CgroupTree {
+public:
+  // Throws std::system_error when `root` is not a cgroup2 mount.
+  explicit CgroupTree(std::string root = "/sys/fs/cgroup");
+  ~CgroupTree() = default;
+
+  CgroupTree(const CgroupTree&) = delete;
+  CgroupTree(CgroupTree&&) = delete;
+  CgroupTree& operator=(const CgroupTree&) = delete;
+  CgroupTree& operator=(CgroupTree&&) = delete;
+
+  std::shared_ptr<Cgroup> GetRoot() const { return _Root; }
+
+  // Returns a non-blocking inotify descriptor watching the hierarchy, or -1 with errno set. The caller owns it and
+  // passes it to Receive. Without it the hierarchy is walked again on every Update.
+  int OpenWatcher();
+  // Drains `fd` as returned by OpenWatcher.
+  void Receive(int fd);
+
+  // Reads the watched cgroups.
+  void Update();
+
+  // Cgroups in depth first order, children sorted by name.
+  void Flatten(std::vector<std::shared_ptr<Cgroup>>& result) const;
+
+private:
+  enum class WatchKind { Directory, Events };
+  struct Watch {
+    std::weak_ptr<Cgroup> Target;
+    WatchKind Kind;
+  };
+  // A cgroup missing one or both of its watches.
+  struct Unwatched {
+    std::weak_ptr<Cgroup> Target;
+    bool Directory;
+    bool Events;
+  };
+
+  void Walk(std::shared_ptr<Cgroup> cgroup);
+  void AddChild(std::shared_ptr<Cgroup> parent, std::string_view name);
+  void AddWatches(std::shared_ptr<Cgroup> cgroup);
+  // Reconciles the children of `cgroup` with its directory, and rereads their cgroup.events.
+  void Rescan(std::shared_ptr<Cgroup> cgroup, bool recursive);
+  void UpdateEvents(std::shared_ptr<Cgroup> cgroup);
+  void PollUnwatched();
+  void Update(Cgroup& cgroup);
+  static void Flatten(const std::shared_ptr<Cgroup>& cgroup, std::vector<std::shared_ptr<Cgroup>>& result);
+
+  const std::string _RootPath;
+  // Every cgroup opens its files below it.
+  const std::shared_ptr<utils::FileHandle> _RootFd;
+  std::shared_ptr<Cgroup> _Root;
+
+  int _NotifyFd = -1;
+  std::unordered_map<int, Watch> _Watches;
+  std::vector<Unwatched> _Unwatched;
+  // Unpopulated cgroups whose cgroup.events changed since the last Update.
+  std::vector<std::weak_ptr<Cgroup>> _Dirty;
+};
+
+} // namespace backend::cgroup
@@ -10,6 +10,8 @@ class ArithmeticBase : public Gauge, public SubscriberBase {
 public:
   explicit ArithmeticBase(std::shared_ptr<Gauge> operand1, std::shared_ptr<Gauge> operand2)
       : _Operand1(operand1), _Operand2(operand2) {
+    RankAbove(*_Operand1);
+    RankAbove(*_Operand2);
     _Operand1->AddSubscribe(*this);
     _Operand2->AddSubscribe(*this);
   }
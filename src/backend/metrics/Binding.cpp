@@ -1,11 +1,112 @@
 #include "Binding.hpp"
 
+#include <algorithm>
+
 namespace backend::metrics {
 
+void SubscriberList::Add(SubscriberBase* subscriber) {
+  if (!_Spilled && _Size < InlineCapacity) {
+    _Inline[_Size++] = subscriber;
+    return;
+  }
+  if (!_Spilled) {
+    _Heap.assign(_Inline.begin(), _Inline.begin() + _Size);
+    _Spilled = true;
+  }
+  _Heap.push_back(subscriber);
+}
+
+void SubscriberList::Remove(SubscriberBase* subscriber) {
+  if (_Notifying > 0) {
+    for (size_t i = 0; i < Size(); ++i) {
+      if (At(i) == subscriber) {
+        At(i) = nullptr;
+        _HasCleared = true;
+      }
+    }
+    return;
+  }
+  if (_Spilled) {
+    std::erase(_Heap, subscriber);
+    return;
+  }
+  auto end = _Inline.begin() + _Size;
+  if (auto it = std::find(_Inline.begin(), end, subscriber); it != end) {
+    std::copy(it + 1, end, it);
+    --_Size;
+  }
+}
+
+void SubscriberList::NotifyAll() {
+  ++_Notifying;
+  // By index, Add may move the list to the heap.
+  for (size_t i = 0; i < Size(); ++i) {
+    if (auto* subscriber = At(i)) {
+      subscriber->OnUpdate();
+    }
+  }
+  if (--_Notifying == 0 && _HasCleared) {
+    Compact();
+  }
+}
+
+void SubscriberList::Compact() {
+  _HasCleared = false;
+  if (_Spilled) {
+    std::erase(_Heap, nullptr);
+    return;
+  }
+  auto end = std::remove(_Inline.begin(), _Inline.begin() + _Size, nullptr);
+  _Size = end - _Inline.begin();
+}
+
+Publisher::~Publisher() {
+  if (_DirtyIndex != NotDirty) {
+    UpdateEpoch::_Dirty[_Rank][_DirtyIndex] = nullptr;
+  }
+}
+
 void Publisher::Notify() {
-  for (auto& subscriber : _Subscribers) {
-    subscriber.get().OnUpdate();
+  // Outside an epoch, an epoch of its own, so the nodes derived from this publisher still run in rank order.
+  UpdateEpoch epoch;
+  UpdateEpoch::MarkDirty(*this);
+}
+
+void Publisher::NotifyNow() { _Subscribers.NotifyAll(); }
+
+void UpdateEpoch::MarkDirty(Publisher& publisher) {
+  if (publisher._DirtyIndex != Publisher::NotDirty) {
+    return;
+  }
+  size_t rank = publisher._Rank;
+  if (rank >= _Dirty.size()) {
+    _Dirty.resize(rank + 1);
+  }
+  publisher._DirtyIndex = _Dirty[rank].size();
+  _Dirty[rank].push_back(&publisher);
+  _LowestDirty = std::min(_LowestDirty, rank);
+}
+
+UpdateEpoch::~UpdateEpoch() {
+  if (_Depth > 1) {
+    --_Depth;
+    return;
+  }
+
+  // Still open while flushing: nodes notified by their inputs are marked at a higher rank and flushed in this same
+  // pass, once however many of their inputs changed. Indexing every time, marking may grow the lists.
+  while (_LowestDirty < _Dirty.size()) {
+    size_t rank = _LowestDirty++;
+    for (size_t i = 0; i < _Dirty[rank].size(); ++i) {
+      if (auto* publisher = _Dirty[rank][i]) {
+        publisher->_DirtyIndex = Publisher::NotDirty;
+        publisher->NotifyNow();
+      }
+    }
+    _Dirty[rank].clear();
   }
+  _LowestDirty = SIZE_MAX;
+  --_Depth;
 }
 
 } // namespace backend::metrics
@@ -1,30 +1,98 @@
 #pragma once
 
-#include <functional>
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
-#include <set>
+#include <vector>
+
+#include "../../utils/Pool.hpp"
 
 namespace backend::metrics {
 
 class Publisher;
 class SubscriberBase;
 
+// Subscribers in the order they subscribed. Most publishers have one or two, which are kept inline; more move to the
+// heap.
+class SubscriberList {
+public:
+  void Add(SubscriberBase* subscriber);
+  void Remove(SubscriberBase* subscriber);
+  // Calls every subscriber. They may subscribe and unsubscribe, themselves or others, while being called: removed ones
+  // are only cleared until the call ends, so no remaining subscriber is skipped, and new ones are called too.
+  void NotifyAll();
+
+private:
+  static constexpr size_t InlineCapacity = 2;
+
+  size_t Size() const { return _Spilled ? _Heap.size() : _Size; }
+  SubscriberBase*& At(size_t index) { return _Spilled ? _Heap[index] : _Inline[index]; }
+  void Compact();
+
+  std::array<SubscriberBase*, InlineCapacity> _Inline;
+  size_t _Size = 0;
+  std::vector<SubscriberBase*> _Heap;
+  bool _Spilled = false;
+  unsigned _Notifying = 0;
+  bool _HasCleared = false;
+};
+
 class Publisher {
 public:
-  virtual ~Publisher() = default;
+  virtual ~Publisher();
 
+  // Marks this publisher to call its subscribers when the UpdateEpoch ends; without one, right away.
   void Notify();
-  void AddSubscribe(SubscriberBase& subscriber) { _Subscribers.insert(std::ref(subscriber)); }
-  void RemoveSubscribe(SubscriberBase& subscriber) { _Subscribers.erase(std::ref(subscriber)); }
+  void AddSubscribe(SubscriberBase& subscriber) { _Subscribers.Add(&subscriber); }
+  void RemoveSubscribe(SubscriberBase& subscriber) { _Subscribers.Remove(&subscriber); }
+
+protected:
+  // For nodes derived from other publishers, which must be called after all of them.
+  void RankAbove(const Publisher& input) { _Rank = std::max(_Rank, input._Rank + 1); }
 
 private:
-  class Comp {
-  public:
-    bool operator()(std::reference_wrapper<SubscriberBase> a, std::reference_wrapper<SubscriberBase> b) const {
-      return std::addressof(a.get()) < std::addressof(b.get());
-    }
-  };
-  std::set<std::reference_wrapper<SubscriberBase>, Comp> _Subscribers;
+  friend class UpdateEpoch;
+
+  static constexpr size_t NotDirty = SIZE_MAX;
+
+  void NotifyNow();
+
+  SubscriberList _Subscribers;
+  // Depth in the graph of derived nodes: 0 for sources, one more than the deepest input otherwise.
+  size_t _Rank = 0;
+  // Position in the dirty list of its rank in the open epoch.
+  size_t _DirtyIndex = NotDirty;
+};
+
+// Batches notifications: while an epoch is open, a publisher notifying is only marked dirty, and its subscribers are
+// called once when the outermost epoch ends. Dirty publishers are called by rank, so a derived node runs once, after
+// all of its inputs are final: a Ratio over a CounterSlice over a Plus of user and system time is evaluated once per
+// sampling pass, and never from a half-updated input. Epochs nest. Like the metrics themselves, they belong to the UI
+// thread.
+class UpdateEpoch {
+public:
+  explicit UpdateEpoch() { ++_Depth; }
+  ~UpdateEpoch();
+
+  UpdateEpoch(const UpdateEpoch&) = delete;
+  UpdateEpoch(UpdateEpoch&&) = delete;
+  UpdateEpoch& operator=(const UpdateEpoch&) = delete;
+  UpdateEpoch& operator=(UpdateEpoch&&) = delete;
+
+  static bool IsOpen() { return _Depth > 0; }
+
+private:
+  friend class Publisher;
+
+  static void MarkDirty(Publisher& publisher);
+
+  static inline unsigned _Depth = 0;
+  // Dirty publishers by rank. Cleared entries belong to publishers destroyed while dirty.
+  static inline std::vector<std::vector<Publisher*>> _Dirty;
+  static inline size_t _LowestDirty = SIZE_MAX;
 };
 
 class SubscriberBase {
@@ -54,7 +122,7 @@ private:
 template <typename PublisherT, typename Callback>
   requires std::derived_from<PublisherT, Publisher> && std::invocable<Callback, std::shared_ptr<PublisherT>>
 std::shared_ptr<SubscriberBase> MakeSubscriber(std::shared_ptr<PublisherT> publisher, Callback&& callback) {
-  return std::make_shared<SubscriberLambda<PublisherT, Callback>>(publisher, std::forward<Callback>(callback));
+  return utils::MakePooled<SubscriberLambda<PublisherT, Callback>>(publisher, std::forward<Callback>(callback));
 }
 
 } // namespace backend::metrics
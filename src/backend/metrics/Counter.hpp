@@ -23,29 +23,55 @@ private:
   DataType _Missed;
 };
 
+// The arithmetic of CounterSlice: splits the growth of a counter into fixed periods, spreading each sample over the
+// periods it spans. Shared with nodes that read their counter in some other way, see expr::Slice.
+class SliceState {
+public:
+  explicit SliceState(std::chrono::steady_clock::duration period, std::chrono::steady_clock::time_point time,
+                      DataType value)
+      : _Period(period), _LastTime(time), _LastValue(value) {}
+
+  // Whether the value changed, i.e. `time` is past a period boundary not seen before. `value` is only read then.
+  template <typename ValueFn> bool Update(std::chrono::steady_clock::time_point time, ValueFn&& value) {
+    if (time <= _LastTime || CutPoint(time) <= CutPoint(_LastTime)) {
+      return false;
+    }
+    Apply(time, value());
+    return true;
+  }
+  DataType GetValue() const { return _CurrentValue; }
+
+  std::chrono::steady_clock::time_point CutPoint(const std::chrono::steady_clock::time_point& time) const;
+
+private:
+  void Apply(std::chrono::steady_clock::time_point time, DataType value);
+
+  const std::chrono::steady_clock::duration _Period;
+  DataType _CurrentValue = 0;
+
+  std::chrono::steady_clock::time_point _LastTime;
+  DataType _LastValue = 0;
+  DataType _RemainingValue = 0;
+};
+
 class CounterSlice : public Gauge, public SubscriberBase {
 public:
   explicit CounterSlice(std::shared_ptr<Gauge> target, std::chrono::steady_clock::duration period)
-      : _Target(target), _Period(period), _LastTime(target->GetLastUpdate()), _LastValue(target->GetValue()) {
+      : _Target(target), _State(period, target->GetLastUpdate(), target->GetValue()) {
+    RankAbove(*_Target);
     _Target->AddSubscribe(*this);
     CounterSlice::OnUpdate();
   }
   ~CounterSlice() { _Target->RemoveSubscribe(*this); }
 
   std::chrono::steady_clock::time_point GetLastUpdate() const override { return _Target->GetLastUpdate(); }
-  DataType GetValue() const override { return _CurrentValue; }
+  DataType GetValue() const override { return _State.GetValue(); }
 
   void OnUpdate() override;
-  std::chrono::steady_clock::time_point CutPoint(const std::chrono::steady_clock::time_point& time);
 
 private:
   const std::shared_ptr<Gauge> _Target;
-  const std::chrono::steady_clock::duration _Period;
-  DataType _CurrentValue = 0;
-
-  std::chrono::steady_clock::time_point _LastTime;
-  DataType _LastValue = 0;
-  DataType _RemainingValue = 0;
+  SliceState _State;
 };
 
 } // namespace backend::metrics
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <memory>
+#include <utility>
+
+#include "../../utils/Pool.hpp"
+#include "Counter.hpp"
+#include "DateType.hpp"
+#include "Gauge.hpp"
+
+// Metric expressions evaluated in one node. `expr::Ratio(expr::Slice(expr::Of(user) + expr::Of(system), period),
+// expr::Of(jiffies))` is a value type whose arithmetic inlines; MakeFused turns it into a single Gauge subscribed once
+// to each leaf, instead of a chain of heap nodes calling each other through GetValue.
+namespace backend::metrics::expr {
+
+template <typename T>
+concept Expression = requires(T& expression, const T& constExpression) {
+  { constExpression.GetValue() } -> std::convertible_to<DataType>;
+  { constExpression.GetLastUpdate() } -> std::convertible_to<std::chrono::steady_clock::time_point>;
+  // Called once per notification of any leaf, before GetValue, for stateful parts like Slice.
+  expression.Update();
+  // Calls `f(Gauge&)` for every leaf.
+  constExpression.ForEachLeaf([](Gauge&) {});
+};
+
+// A gauge as a leaf of an expression.
+class Leaf {
+public:
+  explicit Leaf(std::shared_ptr<Gauge> gauge) : _Gauge(std::move(gauge)) {}
+
+  DataType GetValue() const { return _Gauge->GetValue(); }
+  std::chrono::steady_clock::time_point GetLastUpdate() const { return _Gauge->GetLastUpdate(); }
+  void Update() {}
+  template <typename F> void ForEachLeaf(F&& f) const { f(*_Gauge); }
+
+private:
+  std::shared_ptr<Gauge> _Gauge;
+};
+
+inline Leaf Of(std::shared_ptr<Gauge> gauge) { return Leaf(std::move(gauge)); }
+
+// Two operands combined by `Op`; last updated when the staler operand was, like ArithmeticBase.
+template <Expression A, Expression B, typename Op> class Binary {
+public:
+  explicit Binary(A a, B b) : _A(std::move(a)), _B(std::move(b)) {}
+
+  DataType GetValue() const { return Op()(_A.GetValue(), _B.GetValue()); }
+  std::chrono::steady_clock::time_point GetLastUpdate() const {
+    return std::min(_A.GetLastUpdate(), _B.GetLastUpdate());
+  }
+  void Update() {
+    _A.Update();
+    _B.Update();
+  }
+  template <typename F> void ForEachLeaf(F&& f) const {
+    _A.ForEachLeaf(f);
+    _B.ForEachLeaf(f);
+  }
+
+private:
+  A _A;
+  B _B;
+};
+
+struct PlusOp {
+  DataType operator()(DataType a, DataType b) const { return a + b; }
+};
+struct MinusOp {
+  DataType operator()(DataType a, DataType b) const { return a - b; }
+};
+// As metrics::Ratio: scaled by 10000, and 0 over 0.
+struct RatioOp {
+  DataType operator()(DataType numerator, DataType denominator) const {
+    return denominator == 0 ? 0 : static_cast<double>(numerator) / denominator * 10000;
+  }
+};
+
+template <Expression A, Expression B> Binary<A, B, PlusOp> operator+(A a, B b) {
+  return Binary<A, B, PlusOp>(std::move(a), std::move(b));
+}
+template <Expression A, Expression B> Binary<A, B, MinusOp> operator-(A a, B b) {
+  return Binary<A, B, MinusOp>(std::move(a), std::move(b));
+}
+template <Expression A, Expression B> Binary<A, B, RatioOp> Ratio(A a, B b) {
+  return Binary<A, B, RatioOp>(std::move(a), std::move(b));
+}
+
+// As metrics::CounterSlice, over an expression instead of a gauge.
+template <Expression E> class SliceExpression {
+public:
+  explicit SliceExpression(E target, std::chrono::steady_clock::duration period)
+      : _Target(std::move(target)), _State(period, _Target.GetLastUpdate(), _Target.GetValue()) {}
+
+  DataType GetValue() const { return _State.GetValue(); }
+  std::chrono::steady_clock::time_point GetLastUpdate() const { return _Target.GetLastUpdate(); }
+  void Update() {
+    _Target.Update();
+    _State.Update(_Target.GetLastUpdate(), [this] { return _Target.GetValue(); });
+  }
+  template <typename F> void ForEachLeaf(F&& f) const { _Target.ForEachLeaf(f); }
+
+private:
+  E _Target;
+  SliceState _State;
+};
+
+template <Expression E> SliceExpression<E> Slice(E target, std::chrono::steady_clock::duration period) {
+  return SliceExpression<E>(std::move(target), period);
+}
+
+// An expression as a Gauge, usable wherever one is, including as a leaf of another expression.
+template <Expression E> class Fused : public Gauge, public SubscriberBase {
+public:
+  explicit Fused(E expression) : _Expression(std::move(expression)) {
+    _Expression.ForEachLeaf([this](Gauge& leaf) {
+      RankAbove(leaf);
+      leaf.AddSubscribe(*this);
+    });
+    Fused::OnUpdate();
+  }
+  ~Fused() override {
+    _Expression.ForEachLeaf([this](Gauge& leaf) { leaf.RemoveSubscribe(*this); });
+  }
+
+  std::chrono::steady_clock::time_point GetLastUpdate() const override { return _Expression.GetLastUpdate(); }
+  DataType GetValue() const override { return _Expression.GetValue(); }
+
+  void OnUpdate() override {
+    _Expression.Update();
+    Notify();
+  }
+
+private:
+  E _Expression;
+};
+
+template <Expression E> std::shared_ptr<Fused<E>> MakeFused(E expression) {
+  return utils::MakePooled<Fused<E>>(std::move(expression));
+}
+
+} // namespace backend::metrics::expr
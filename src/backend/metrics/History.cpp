@@ -0,0 +1,117 @@
+#include "History.hpp"
+
+#include <algorithm>
+
+namespace backend::metrics {
+
+const std::array<History::Resolution, 3> History::DefaultResolutions{{
+    {std::chrono::seconds(1), 300},
+    {std::chrono::seconds(10), 360},
+    {std::chrono::minutes(1), 1440},
+}};
+
+History::History(std::shared_ptr<Gauge> gauge, std::span<const Resolution> resolutions) : _Gauge(gauge) {
+  _Rings.reserve(resolutions.size());
+  for (auto& resolution : resolutions) {
+    _Rings.emplace_back(resolution);
+  }
+  _Gauge->AddSubscribe(*this);
+  History::OnUpdate();
+}
+
+History::~History() { _Gauge->RemoveSubscribe(*this); }
+
+void History::OnUpdate() {
+  auto time = _Gauge->GetLastUpdate();
+  auto value = _Gauge->GetValue();
+  if (!_Empty && time < _LastTime) {
+    return;
+  }
+
+  if (!_Empty && time == _LastTime) {
+    // Notified again for the same sample, e.g. a derived gauge whose operands were updated one by one.
+    if (value != _LastValue) {
+      for (auto& ring : _Rings) {
+        ring.Replace(_LastValue, value);
+      }
+      _LastValue = value;
+    }
+    return;
+  }
+
+  for (auto& ring : _Rings) {
+    ring.Add(time, value);
+  }
+  _LastTime = time;
+  _LastValue = value;
+  _Empty = false;
+}
+
+void History::Query(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to,
+                    std::vector<Sample>& result) const {
+  result.clear();
+  if (_Rings.empty()) {
+    return;
+  }
+  auto it = std::ranges::find_if(_Rings, [from](auto& ring) { return ring.GetOldest() <= from; });
+  (it != _Rings.end() ? *it : _Rings.back()).Query(from, to, result);
+}
+
+size_t History::GetMemoryUsage() const {
+  size_t result = 0;
+  for (auto& ring : _Rings) {
+    result += ring.GetMemoryUsage();
+  }
+  return result;
+}
+
+History::Ring::Ring(const Resolution& resolution)
+    : _Interval(resolution.Interval), _Samples(std::max<size_t>(resolution.Capacity, 1)) {}
+
+void History::Ring::Add(std::chrono::steady_clock::time_point time, DataType value) {
+  auto bucket = std::chrono::steady_clock::time_point(time.time_since_epoch() / _Interval * _Interval);
+  if (_Count > 0 && bucket != _BucketStart) {
+    Close();
+  }
+  if (_Count == 0) {
+    _BucketStart = bucket;
+  }
+  _Sum += value;
+  ++_Count;
+}
+
+void History::Ring::Replace(DataType previous, DataType value) {
+  // Wraps around correctly, the sum includes `previous`.
+  _Sum = _Sum - previous + value;
+}
+
+void History::Ring::Close() {
+  _Samples[_Head] = Open();
+  _Head = (_Head + 1) % _Samples.size();
+  _Size = std::min(_Size + 1, _Samples.size());
+  _Sum = 0;
+  _Count = 0;
+}
+
+std::chrono::steady_clock::time_point History::Ring::GetOldest() const {
+  if (_Size > 0) {
+    return _Samples[(_Head + _Samples.size() - _Size) % _Samples.size()].Time;
+  }
+  return _Count > 0 ? _BucketStart : std::chrono::steady_clock::time_point::max();
+}
+
+void History::Ring::Query(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to,
+                          std::vector<Sample>& result) const {
+  auto overlaps = [&](const Sample& sample) { return sample.Time + _Interval > from && sample.Time <= to; };
+  for (size_t i = _Size; i > 0; --i) {
+    auto& sample = _Samples[(_Head + _Samples.size() - i) % _Samples.size()];
+    if (overlaps(sample)) {
+      result.push_back(sample);
+    }
+  }
+  if (_Count > 0 && overlaps(Open())) {
+    result.push_back(Open());
+  }
+}
+
+} // namespace backend::metrics
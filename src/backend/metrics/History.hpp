@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Binding.hpp"
+#include "DateType.hpp"
+#include "Gauge.hpp"
+
+namespace backend::metrics {
+
+// Past values of a gauge, kept at several resolutions in rings allocated up front: recent ones at a fine resolution,
+// older ones averaged over longer intervals. The memory is fixed by the resolutions; recording a value never
+// allocates.
+class History : public SubscriberBase {
+public:
+  struct Resolution {
+    std::chrono::steady_clock::duration Interval;
+    // Samples kept, i.e. this resolution spans Interval * Capacity.
+    size_t Capacity;
+  };
+  // 1s for 5 minutes, 10s for an hour, 1m for a day; about 33KiB.
+  static const std::array<Resolution, 3> DefaultResolutions;
+
+  struct Sample {
+    // Start of the interval the value is the mean of.
+    std::chrono::steady_clock::time_point Time;
+    DataType Value;
+  };
+
+  // Resolutions from the finest to the coarsest.
+  explicit History(std::shared_ptr<Gauge> gauge, std::span<const Resolution> resolutions = DefaultResolutions);
+  ~History() override;
+
+  History(const History&) = delete;
+  History(History&&) = delete;
+  History& operator=(const History&) = delete;
+  History& operator=(History&&) = delete;
+
+  void OnUpdate() override;
+
+  // Samples from `from` to `to`, oldest first, into `result`, at the finest resolution still reaching back to `from`,
+  // or the coarsest one if none does. The last sample may cover an interval still in progress.
+  void Query(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to,
+             std::vector<Sample>& result) const;
+  // Bytes held by the rings.
+  size_t GetMemoryUsage() const;
+
+private:
+  class Ring {
+  public:
+    explicit Ring(const Resolution& resolution);
+
+    void Add(std::chrono::steady_clock::time_point time, DataType value);
+    // Replaces the value last added, for a gauge notifying again without a new sample.
+    void Replace(DataType previous, DataType value);
+    std::chrono::steady_clock::time_point GetOldest() const;
+    void Query(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to,
+               std::vector<Sample>& result) const;
+    size_t GetMemoryUsage() const { return _Samples.capacity() * sizeof(Sample); }
+
+  private:
+    void Close();
+    Sample Open() const { return {_BucketStart, _Sum / _Count}; }
+
+    const std::chrono::steady_clock::duration _Interval;
+    std::vector<Sample> _Samples;
+    // Next slot to write, and the number of closed samples.
+    size_t _Head = 0;
+    size_t _Size = 0;
+
+    // The interval in progress.
+    std::chrono::steady_clock::time_point _BucketStart;
+    DataType _Sum = 0;
+    size_t _Count = 0;
+  };
+
+  const std::shared_ptr<Gauge> _Gauge;
+  std::vector<Ring> _Rings;
+  std::chrono::steady_clock::time_point _LastTime;
+  DataType _LastValue = 0;
+  bool _Empty = true;
+};
+
+} // namespace backend::metrics
@@ -0,0 +1,133 @@
+#include "Statistics.hpp"
+
+#include <cmath>
+#include <array>
+#include <limits>
+
+namespace backend::metrics {
+
+Ewma::Ewma(std::shared_ptr<Gauge> target, std::chrono::steady_clock::duration tau)
+    : _Target(target), _Tau(std::chrono::duration<double>(tau).count()) {
+  RankAbove(*_Target);
+  _Target->AddSubscribe(*this);
+  Ewma::OnUpdate();
+}
+
+void Ewma::OnUpdate() {
+  auto time = _Target->GetLastUpdate();
+  auto value = static_cast<double>(_Target->GetValue());
+  if (_Empty) {
+    _Average = value;
+    _Empty = false;
+  } else if (time > _LastTime) {
+    double elapsed = std::chrono::duration<double>(time - _LastTime).count();
+    _Average += (value - _Average) * -std::expm1(-elapsed / _Tau);
+  } else {
+    return;
+  }
+  _LastTime = time;
+  Notify();
+}
+
+QuantileSketch::QuantileSketch(double accuracy)
+    : _Gamma((1 + accuracy) / (1 - accuracy)), _LogGamma(std::log(_Gamma)),
+      _Buckets(static_cast<size_t>(std::ceil(std::numeric_limits<DataType>::digits * std::log(2.0) / _LogGamma)) + 2) {}
+
+size_t QuantileSketch::GetBucket(DataType value) const {
+  if (value == 0) {
+    return 0;
+  }
+  auto bucket = static_cast<size_t>(std::ceil(std::log(static_cast<double>(value)) / _LogGamma)) + 1;
+  return std::min(bucket, _Buckets.size() - 1);
+}
+
+DataType QuantileSketch::GetBucketValue(size_t bucket) const {
+  if (bucket == 0) {
+    return 0;
+  }
+  double value = 2 * std::pow(_Gamma, static_cast<double>(bucket - 1)) / (_Gamma + 1);
+  if (value >= static_cast<double>(std::numeric_limits<DataType>::max())) {
+    return std::numeric_limits<DataType>::max();
+  }
+  return static_cast<DataType>(std::llround(value));
+}
+
+void QuantileSketch::Add(DataType value) {
+  ++_Buckets[GetBucket(value)];
+  ++_Count;
+}
+
+void QuantileSketch::Merge(const QuantileSketch& other) {
+  for (size_t i = 0; i < _Buckets.size(); ++i) {
+    _Buckets[i] += other._Buckets[i];
+  }
+  _Count += other._Count;
+}
+
+void QuantileSketch::Clear() {
+  std::ranges::fill(_Buckets, 0);
+  _Count = 0;
+}
+
+DataType QuantileSketch::GetQuantile(std::span<const QuantileSketch* const> sketches, double quantile) {
+  uint64_t count = 0;
+  for (auto* sketch : sketches) {
+    count += sketch->_Count;
+  }
+  if (count == 0) {
+    return 0;
+  }
+
+  auto rank = static_cast<uint64_t>(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(count - 1));
+  uint64_t seen = 0;
+  const auto& first = *sketches.front();
+  for (size_t i = 0; i < first._Buckets.size(); ++i) {
+    for (auto* sketch : sketches) {
+      seen += sketch->_Buckets[i];
+    }
+    if (seen > rank) {
+      return first.GetBucketValue(i);
+    }
+  }
+  return first.GetBucketValue(first._Buckets.size() - 1);
+}
+
+Quantile::Quantile(std::shared_ptr<Gauge> target, double quantile, std::chrono::steady_clock::duration window,
+                   double accuracy)
+    : _Target(target), _Quantile(quantile), _Window(window), _Current(accuracy), _Previous(accuracy) {
+  RankAbove(*_Target);
+  _Target->AddSubscribe(*this);
+  Quantile::OnUpdate();
+}
+
+DataType Quantile::GetValue() const {
+  const std::array<const QuantileSketch*, 2> sketches{&_Current, &_Previous};
+  return QuantileSketch::GetQuantile(sketches, _Quantile);
+}
+
+void Quantile::OnUpdate() {
+  auto time = _Target->GetLastUpdate();
+  if (!_Empty && time <= _LastTime) {
+    return;
+  }
+
+  if (_Empty) {
+    _WindowStart = time;
+  } else if (time >= _WindowStart + 2 * _Window) {
+    // Nothing sampled for a whole window, both sketches are out of date.
+    _Previous.Clear();
+    _Current.Clear();
+    _WindowStart = time;
+  } else if (time >= _WindowStart + _Window) {
+    std::swap(_Previous, _Current);
+    _Current.Clear();
+    _WindowStart += _Window;
+  }
+
+  _Current.Add(_Target->GetValue());
+  _LastTime = time;
+  _Empty = false;
+  Notify();
+}
+
+} // namespace backend::metrics
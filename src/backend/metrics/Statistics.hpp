@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stdint.h>
+#include <vector>
+
+#include "Binding.hpp"
+#include "DateType.hpp"
+#include "Gauge.hpp"
+
+namespace backend::metrics {
+
+// Exponentially weighted moving average over time, like the load average: a sample `dt` after the previous one
+// weighs 1 - exp(-dt / tau), however irregular the samples are.
+class Ewma : public Gauge, public SubscriberBase {
+public:
+  explicit Ewma(std::shared_ptr<Gauge> target, std::chrono::steady_clock::duration tau);
+  ~Ewma() override { _Target->RemoveSubscribe(*this); }
+
+  std::chrono::steady_clock::time_point GetLastUpdate() const override { return _Target->GetLastUpdate(); }
+  DataType GetValue() const override { return static_cast<DataType>(_Average + 0.5); }
+
+  void OnUpdate() override;
+
+private:
+  const std::shared_ptr<Gauge> _Target;
+  const double _Tau;
+  double _Average = 0;
+  std::chrono::steady_clock::time_point _LastTime;
+  bool _Empty = true;
+};
+
+// The largest (SlidingMax) or smallest (SlidingMin) value of the samples within the last `window`. Samples which can
+// never be the extremum again are dropped as soon as a better one arrives, so the deque stays short and every sample
+// is pushed and popped once. At most `capacity` samples are kept; beyond that the oldest go first, shortening the
+// window.
+template <typename Better> class SlidingExtremum : public Gauge, public SubscriberBase {
+public:
+  explicit SlidingExtremum(std::shared_ptr<Gauge> target, std::chrono::steady_clock::duration window,
+                           size_t capacity = 1024)
+      : _Target(target), _Window(window), _Capacity(std::max<size_t>(capacity, 1)) {
+    RankAbove(*_Target);
+    _Target->AddSubscribe(*this);
+    SlidingExtremum::OnUpdate();
+  }
+  ~SlidingExtremum() override { _Target->RemoveSubscribe(*this); }
+
+  std::chrono::steady_clock::time_point GetLastUpdate() const override { return _Target->GetLastUpdate(); }
+  DataType GetValue() const override { return _Samples.empty() ? 0 : _Samples.front().Value; }
+
+  void OnUpdate() override {
+    auto time = _Target->GetLastUpdate();
+    auto value = _Target->GetValue();
+    if (!_Samples.empty() && time < _Samples.back().Time) {
+      return;
+    }
+
+    auto previous = GetValue();
+    while (!_Samples.empty() && !Better()(_Samples.back().Value, value)) {
+      _Samples.pop_back();
+    }
+    if (_Samples.size() == _Capacity) {
+      _Samples.pop_front();
+    }
+    _Samples.push_back({time, value});
+    while (_Samples.front().Time + _Window <= time) {
+      _Samples.pop_front();
+    }
+
+    if (GetValue() != previous) {
+      Notify();
+    }
+  }
+
+private:
+  struct Sample {
+    std::chrono::steady_clock::time_point Time;
+    DataType Value;
+  };
+
+  const std::shared_ptr<Gauge> _Target;
+  const std::chrono::steady_clock::duration _Window;
+  const size_t _Capacity;
+  // Ordered by time, and strictly better towards the front.
+  std::deque<Sample> _Samples;
+};
+
+using SlidingMax = SlidingExtremum<std::greater<>>;
+using SlidingMin = SlidingExtremum<std::less<>>;
+
+// Approximate quantiles with relative error `accuracy`: a value v > 0 lands in bucket ceil(log_gamma(v)) with
+// gamma = (1 + accuracy) / (1 - accuracy), whose midpoint is within `accuracy` of v. The buckets cover all of
+// DataType, so the memory is fixed, about 9KiB at 1%. Sketches of the same accuracy merge by adding their buckets.
+class QuantileSketch {
+public:
+  explicit QuantileSketch(double accuracy = 0.01);
+
+  void Add(DataType value);
+  void Merge(const QuantileSketch& other);
+  void Clear();
+
+  uint64_t GetCount() const { return _Count; }
+  // `quantile` in [0, 1]. 0 for an empty sketch.
+  DataType GetQuantile(double quantile) const {
+    const QuantileSketch* self = this;
+    return GetQuantile({&self, 1}, quantile);
+  }
+  // Of the union of sketches of the same accuracy, without merging them.
+  static DataType GetQuantile(std::span<const QuantileSketch* const> sketches, double quantile);
+
+private:
+  size_t GetBucket(DataType value) const;
+  DataType GetBucketValue(size_t bucket) const;
+
+  double _Gamma;
+  double _LogGamma;
+  uint64_t _Count = 0;
+  // Bucket 0 holds the zeros.
+  std::vector<uint32_t> _Buckets;
+};
+
+// A quantile of the samples of the last `window` to 2 * `window`: samples go to the current sketch, which replaces
+// the previous one every `window`. Adding a sample is constant time; the quantile is computed when read.
+class Quantile : public Gauge, public SubscriberBase {
+public:
+  explicit Quantile(std::shared_ptr<Gauge> target, double quantile, std::chrono::steady_clock::duration window,
+                    double accuracy = 0.01);
+  ~Quantile() override { _Target->RemoveSubscribe(*this); }
+
+  std::chrono::steady_clock::time_point GetLastUpdate() const override { return _Target->GetLastUpdate(); }
+  DataType GetValue() const override;
+
+  void OnUpdate() override;
+
+private:
+  const std::shared_ptr<Gauge> _Target;
+  const double _Quantile;
+  const std::chrono::steady_clock::duration _Window;
+  QuantileSketch _Current;
+  QuantileSketch _Previous;
+  std::chrono::steady_clock::time_point _WindowStart;
+  std::chrono::steady_clock::time_point _LastTime;
+  bool _Empty = true;
+};
+
+} // namespace backend::metrics
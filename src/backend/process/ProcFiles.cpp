@@ -0,0 +1,200 @@
+#include "ProcFiles.hpp"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace backend::process {
+
+ProcFileBudget& ProcFileBudget::GetInstance() {
+  static ProcFileBudget instance(DefaultLimit());
+  return instance;
+}
+
+size_t ProcFileBudget::DefaultLimit() {
+  // Leave a quarter of RLIMIT_NOFILE to everything else: terminal, epoll, timers, BPF objects.
+  struct rlimit limit;
+  PosixE(getrlimit(RLIMIT_NOFILE, &limit));
+  rlim_t current = std::min<rlim_t>(limit.rlim_cur, 1 << 20);
+  return std::max<rlim_t>(current / 4 * 3, 16);
+}
+
+void ProcFileBudget::Pin(ProcFiles& files) {
+  unsigned pins = files._Pins.load(std::memory_order_relaxed);
+  while (true) {
+    if (pins & ProcFiles::Evicting) {
+      // The eviction holds the lock until the descriptors are closed, wait for it.
+      std::lock_guard lock(_Lock);
+      pins = files._Pins.load(std::memory_order_relaxed);
+    } else if (files._Pins.compare_exchange_weak(pins, pins + 1, std::memory_order_acquire,
+                                                 std::memory_order_relaxed)) {
+      break;
+    }
+  }
+
+  // Only written when it changes, the flag shares its cache line with the pins.
+  if (!files._Referenced.load(std::memory_order_relaxed)) {
+    files._Referenced.store(true, std::memory_order_relaxed);
+  }
+}
+
+void ProcFileBudget::Unpin(ProcFiles& files) { files._Pins.fetch_sub(1, std::memory_order_release); }
+
+void ProcFileBudget::Acquire(ProcFiles& files) {
+  std::lock_guard lock(_Lock);
+  ++_Open;
+  if (!files._InClock) {
+    // Right behind the hand, the last to be swept.
+    files._ClockPosition = _Clock.insert(_Hand, &files);
+    files._InClock = true;
+  }
+  EvictLocked();
+}
+
+void ProcFileBudget::Charge(size_t count) {
+  std::lock_guard lock(_Lock);
+  _Open += count;
+  EvictLocked();
+}
+
+void ProcFileBudget::Refund(size_t count) {
+  std::lock_guard lock(_Lock);
+  _Open -= count;
+}
+
+void ProcFileBudget::EvictLocked() {
+  // Each ProcFiles is passed at most twice: once to clear its flag, once to evict it. Skips whatever is being read
+  // right now, including the caller of Acquire.
+  for (size_t steps = 2 * _Clock.size(); _Open > _Limit && steps > 0; --steps) {
+    if (_Hand == _Clock.end()) {
+      _Hand = _Clock.begin();
+    }
+    ProcFiles& victim = **_Hand;
+    unsigned idle = 0;
+    if (victim._Referenced.exchange(false, std::memory_order_relaxed) ||
+        !victim._Pins.compare_exchange_strong(idle, ProcFiles::Evicting, std::memory_order_acquire)) {
+      ++_Hand;
+      continue;
+    }
+    // CloseLocked moves the hand past the victim.
+    CloseLocked(victim);
+    victim._Pins.store(0, std::memory_order_release);
+  }
+}
+
+void ProcFileBudget::Close(ProcFiles& files) {
+  std::lock_guard lock(_Lock);
+  CloseLocked(files);
+}
+
+void ProcFileBudget::CloseLocked(ProcFiles& files) {
+  size_t count = std::ranges::count_if(files._Fds, [](auto& fd) { return fd.has_value(); }) + (files._DirFd ? 1 : 0);
+  for (auto& fd : files._Fds) {
+    fd.reset();
+  }
+  files._DirFd.reset();
+  _Open -= count;
+
+  if (files._InClock) {
+    if (_Hand == files._ClockPosition) {
+      ++_Hand;
+    }
+    _Clock.erase(files._ClockPosition);
+    files._InClock = false;
+  }
+}
+
+const std::array<const char*, ProcFiles::FileCount> ProcFiles::_FileNames{"stat", "io", "cmdline", "status",
+                                                                            "smaps_rollup"};
+
+ProcFiles::~ProcFiles() { ProcFileBudget::GetInstance().Close(*this); }
+
+ssize_t ProcFiles::Read(File file, std::span<char> buffer, off_t offset) {
+  int fd = BeginRead(file);
+  if (fd < 0) {
+    return -1;
+  }
+
+  ssize_t bytes = pread(fd, buffer.data(), buffer.size(), offset);
+  EndRead(file, bytes < 0 ? errno : 0);
+  return bytes;
+}
+
+int ProcFiles::BeginRead(File file) {
+  if (_Gone) {
+    errno = ESRCH;
+    return -1;
+  }
+
+  auto& budget = ProcFileBudget::GetInstance();
+  budget.Pin(*this);
+
+  int fd = Open(file);
+  if (fd < 0) {
+    int err = errno;
+    budget.Unpin(*this);
+    errno = err;
+  }
+  return fd;
+}
+
+void ProcFiles::EndRead(File file, int err) {
+  ProcFileBudget::GetInstance().Unpin(*this);
+  if (err != 0) {
+    Fail(file, err);
+  }
+}
+
+int ProcFiles::Open(File file) {
+  auto index = static_cast<size_t>(file);
+  if (_Fds[index]) {
+    return *_Fds[index];
+  } else if (_Unavailable[index] != 0) {
+    errno = _Unavailable[index];
+    return -1;
+  }
+
+  auto& budget = ProcFileBudget::GetInstance();
+  if (!_DirFd) {
+    int dirFd = openat(_ParentFd, _Name.c_str(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) {
+      int err = errno;
+      if (err == ENOENT || err == ESRCH) {
+        SetGone();
+      }
+      errno = err;
+      return -1;
+    }
+    _DirFd.emplace(dirFd);
+    budget.Acquire(*this);
+  }
+
+  int fd = openat(*_DirFd, _FileNames[index], O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    Fail(file, errno);
+    return -1;
+  }
+  _Fds[index].emplace(fd);
+  budget.Acquire(*this);
+  return fd;
+}
+
+void ProcFiles::Fail(File file, int err) {
+  if (file == File::Stat && (err == ENOENT || err == ESRCH)) {
+    // stat exists for as long as the process does.
+    SetGone();
+  } else if (file != File::Stat && (err == ENOENT || err == EACCES || err == EPERM)) {
+    // An optional file the kernel lacks, e.g. io without task io accounting, or another user's io. Don't retry on
+    // every tick; if the process is gone instead, stat tells.
+    _Unavailable[static_cast<size_t>(file)] = err;
+  }
+  errno = err;
+}
+
+void ProcFiles::SetGone() {
+  _Gone = true;
+  ProcFileBudget::GetInstance().Close(*this);
+}
+
+} // namespace backend::process
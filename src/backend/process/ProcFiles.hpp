@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+
+#include "../../utils/Error.hpp"
+
+namespace backend::process {
+
+class ProcFiles;
+
+// Bounds the number of procfs descriptors kept open by all ProcFiles together. When the budget is exhausted, a
+// ProcFiles not read recently closes its descriptors and reopens them on its next read; recency is tracked the CLOCK
+// way, with a referenced flag swept by a hand, so reads don't reorder a shared list. ProcFiles may be read from several
+// threads at once; a ProcFiles is pinned while it is being read and never evicted then. Pinning is lock-free, the lock
+// is only taken to open, close and evict. Descriptors kept open elsewhere, e.g. of cgroups, are charged to the same
+// budget.
+class ProcFileBudget {
+public:
+  static ProcFileBudget& GetInstance();
+
+  explicit ProcFileBudget(size_t limit) : _Limit(limit) {}
+  ~ProcFileBudget() = default;
+
+  ProcFileBudget(const ProcFileBudget&) = delete;
+  ProcFileBudget(ProcFileBudget&&) = delete;
+  ProcFileBudget& operator=(const ProcFileBudget&) = delete;
+  ProcFileBudget& operator=(ProcFileBudget&&) = delete;
+
+  // For descriptors not owned by a ProcFiles: charging evicts ProcFiles to make room, but charged descriptors are never
+  // evicted themselves.
+  void Charge(size_t count);
+  void Refund(size_t count);
+
+  size_t GetLimit() const { return _Limit; }
+  size_t GetOpen() const {
+    std::lock_guard lock(_Lock);
+    return _Open;
+  }
+
+private:
+  friend class ProcFiles;
+
+  void Pin(ProcFiles& files);
+  void Unpin(ProcFiles& files);
+  void Acquire(ProcFiles& files);
+  void Close(ProcFiles& files);
+  void CloseLocked(ProcFiles& files);
+  void EvictLocked();
+
+  static size_t DefaultLimit();
+
+  const size_t _Limit;
+  mutable std::mutex _Lock;
+  size_t _Open = 0;
+  // Every ProcFiles holding descriptors, in a ring swept by _Hand.
+  std::list<ProcFiles*> _Clock;
+  std::list<ProcFiles*>::iterator _Hand = _Clock.end();
+};
+
+// Descriptors of the hot files of one /proc/<pid> directory, resampled with pread at offset 0. The directory is held by
+// an O_PATH descriptor, which keeps pointing at the same process while open. Once evicted by the budget it is reopened
+// by name, which may reach a new process that reused the pid; Process catches that by its start time (see
+// Process::IsRecycled).
+class ProcFiles {
+public:
+  enum class File { Stat, Io, Cmdline, Status, SmapsRollup, Count };
+
+  // `dirFd` must stay open for the lifetime of this object, `name` is the process directory relative to it.
+  explicit ProcFiles(int dirFd, std::string_view name) : _ParentFd(dirFd), _Name(name) {}
+  ~ProcFiles();
+
+  ProcFiles(const ProcFiles&) = delete;
+  ProcFiles(ProcFiles&&) = delete;
+  ProcFiles& operator=(const ProcFiles&) = delete;
+  ProcFiles& operator=(ProcFiles&&) = delete;
+
+  // A single pread of `file`. Returns the number of bytes read, or -1 with errno set. Once the process is found to
+  // be gone (ENOENT/ESRCH from the directory or stat) all descriptors are dropped and every later read fails with
+  // ESRCH. A file that is missing or denied, e.g. io without task io accounting, fails the same way from then on.
+  // Reads of different ProcFiles may run concurrently, reads of the same one may not.
+  ssize_t Read(File file, std::span<char> buffer, off_t offset = 0);
+  // For reads issued elsewhere, e.g. through io_uring. BeginRead returns the descriptor of `file`, or -1 with errno
+  // set, and keeps it from being evicted until the matching EndRead, which takes the errno of the read or 0.
+  int BeginRead(File file);
+  void EndRead(File file, int err);
+  bool IsGone() const { return _Gone; }
+
+private:
+  friend class ProcFileBudget;
+
+  static constexpr size_t FileCount = static_cast<size_t>(File::Count);
+  static const std::array<const char*, FileCount> _FileNames;
+
+  int Open(File file);
+  void Fail(File file, int err);
+  void SetGone();
+
+  const int _ParentFd;
+  const std::string _Name;
+  std::optional<utils::FileHandle> _DirFd;
+  std::array<std::optional<utils::FileHandle>, FileCount> _Fds;
+  // The errno each file failed to open or read with for good, 0 while it is available.
+  std::array<int, FileCount> _Unavailable{};
+  bool _Gone = false;
+
+  // Readers in progress, or Evicting while the budget closes the descriptors.
+  static constexpr unsigned Evicting = 1u << 31;
+  std::atomic<unsigned> _Pins = 0;
+  // Read since the hand last passed.
+  std::atomic<bool> _Referenced = false;
+  // Guarded by the budget lock.
+  bool _InClock = false;
+  std::list<ProcFiles*>::iterator _ClockPosition;
+};
+
+} // namespace backend::process
@@ -1,190 +1,453 @@
 #include "Process.hpp"
 
 #include <algorithm>
-#include <fcntl.h>
-#include <fstream>
-#include <ranges>
-#include <regex>
-#include <sstream>
+#include <cstring>
 #include <string>
+#include <tuple>
 
 #include "../../utils/Clock.hpp"
 #include "../../utils/Error.hpp"
+#include "../../utils/FieldParser.hpp"
+#include "../../utils/Pool.hpp"
 
 namespace backend::process {
 
-void Process::Update() {
-  ParseStatFile();
-  if (_Exists) {
-    ParseIoFile();
+void Process::Sample() {
+  _Pending.Exists = false;
+  _Pending.HasIo.reset();
+  _Pending.HasMemory.reset();
+  if (_Files.IsGone()) {
+    return;
+  }
+
+  StatParser::Buffer stat;
+  if (ssize_t size = _Files.Read(ProcFiles::File::Stat, stat); size > 0) {
+    ParseStatFile({stat.data(), static_cast<size_t>(size)});
+  }
+
+  if (_Pending.Exists && WantsIo()) {
+    std::array<char, 512> io;
+    if (ssize_t size = _Files.Read(ProcFiles::File::Io, io); size > 0) {
+      ParseIoFile({io.data(), static_cast<size_t>(size)});
+    }
+  }
+
+  if (_Pending.Exists && WantsMemory()) {
+    SampleMemory();
   }
 }
 
-std::string Process::GetCommandLine() const {
-  std::ostringstream result;
+void Process::PrepareSample(std::span<BatchRead, 2> reads, SampleBuffers& buffers) {
+  _Pending.Exists = false;
+  _Pending.HasIo.reset();
+  _Pending.HasMemory.reset();
+  reads[0] = {.Fd = -1, .Buffer = buffers.Stat};
+  reads[1] = {.Fd = -1, .Buffer = buffers.Io};
+  if (_Files.IsGone()) {
+    return;
+  }
+
+  // Unlike Sample, io is read even if stat turns out to fail; that is rare and saves a round trip.
+  reads[0].Fd = _Files.BeginRead(ProcFiles::File::Stat);
+  if (reads[0].Fd >= 0 && WantsIo()) {
+    reads[1].Fd = _Files.BeginRead(ProcFiles::File::Io);
+  }
+}
 
-  try {
-    utils::FileHandle fd(PosixE(open((_ProcDirPath / "cmdline").c_str(), O_RDONLY)));
-    std::array<char, 1024> buffer;
-    for (ssize_t bytes = PosixE(read(fd, buffer.data(), buffer.size())); bytes > 0;
-         bytes = PosixE(read(fd, buffer.data(), buffer.size()))) {
-      result.write(buffer.data(), bytes);
+void Process::CompleteSample(std::span<const BatchRead, 2> reads) {
+  constexpr std::array files{ProcFiles::File::Stat, ProcFiles::File::Io};
+  for (size_t i = 0; i < reads.size(); ++i) {
+    if (reads[i].Fd >= 0) {
+      _Files.EndRead(files[i], reads[i].Result < 0 ? -reads[i].Result : 0);
     }
-  } catch (const std::system_error& e) {
-    if (e.code() == std::errc::no_such_file_or_directory || e.code() == std::errc::no_such_process) {
-      return _Info.comm;
+  }
+
+  if (reads[0].Fd >= 0 && reads[0].Result > 0) {
+    ParseStatFile({reads[0].Buffer.data(), static_cast<size_t>(reads[0].Result)});
+  }
+
+  if (_Pending.Exists && reads[1].Fd >= 0 && reads[1].Result > 0) {
+    ParseIoFile({reads[1].Buffer.data(), static_cast<size_t>(reads[1].Result)});
+  }
+
+  // Only watched processes get here, few enough to read synchronously.
+  if (_Pending.Exists && WantsMemory()) {
+    SampleMemory();
+  }
+}
+
+void Process::PublishMemory() {
+  for (size_t i = 0; i < MemoryFieldCount; ++i) {
+    if (!_Pending.HasMemory[i]) {
+      continue;
+    }
+    if (auto ptr = _MemoryGauges[i].lock()) {
+      ptr->SetValue(_Pending.Memory[i]);
+    }
+  }
+}
+
+void Process::SampleMemory() {
+  ParseMemoryFile(ProcFiles::File::Status, _StatusKeys);
+
+  auto now = std::chrono::steady_clock::now();
+  if (_MemoryPriority || now >= _SmapsDue) {
+    if (ParseMemoryFile(ProcFiles::File::SmapsRollup, _SmapsKeys)) {
+      auto cost = std::chrono::steady_clock::now() - now;
+      _SmapsDue = now + std::min<std::chrono::steady_clock::duration>(cost * SmapsCostFactor, SmapsMaxInterval);
     } else {
-      throw;
+      // Denied or a kernel thread without an address space, don't keep trying.
+      _SmapsDue = now + SmapsMaxInterval;
     }
   }
+}
 
-  if (result.tellp() == 0) {
-    return _Info.comm;
-  } else {
-    return result.str();
-  }
-}
-
-void Process::ParseStatFile() {
-  struct ProcessStat {
-    char state;
-    int pgrp;
-    int session;
-    int tty_nr;
-    int tpgid;
-    unsigned int flags;
-    unsigned long minflt;
-    unsigned long cminflt;
-    unsigned long majflt;
-    unsigned long cmajflt;
-    unsigned long utime;
-    unsigned long stime;
-    long cutime;
-    long cstime;
-    long priority;
-    long nice;
-    long num_threads;
-    long itrealvalue;
-    unsigned long long starttime;
-    unsigned long vsize;
-    long rss;
-  };
+bool Process::ParseMemoryFile(ProcFiles::File file, std::span<const MemoryKey> keys) {
+  std::array<char, 4096> buffer;
+  ssize_t size = _Files.Read(file, buffer);
+  if (size <= 0) {
+    return false;
+  }
 
-  ProcessStat ps;
-  std::ifstream ifs(_ProcDirPath / "stat");
+  // Fields spread over several keys are summed, so clear the ones this file provides first.
+  for (auto& key : keys) {
+    auto index = static_cast<size_t>(key.Field);
+    _Pending.Memory[index] = 0;
+    _Pending.HasMemory.set(index);
+  }
 
-  if (!ifs.is_open()) {
-    _Exists = false;
-    return;
+  utils::FieldParser parser({buffer.data(), static_cast<size_t>(size)});
+  std::string_view key;
+  do {
+    if (!parser.Next(key)) {
+      break;
+    }
+
+    auto match = std::ranges::find(keys, key, &MemoryKey::Key);
+    metrics::DataType value;
+    if (match != keys.end() && parser.Next(value)) {
+      // Both files report kB.
+      _Pending.Memory[static_cast<size_t>(match->Field)] += value * 1024;
+    }
+  } while (parser.NextLine());
+  return true;
+}
+
+bool Process::IsNewIncarnation(std::chrono::steady_clock::time_point start) {
+  // No start time yet means never updated.
+  if (!_Recycled && (_StartTime == std::chrono::steady_clock::time_point() || start == _StartTime)) {
+    return false;
   }
+  _Recycled = true;
+  return true;
+}
 
-  std::string content;
-  try {
-    content = std::string(std::istreambuf_iterator<char>(ifs), {});
-  } catch (const std::ios_base::failure& e) {
-    _Exists = false;
-    return;
+void Process::SetValues(ProcessSnapshot::Values values, std::chrono::steady_clock::time_point time) {
+  using Column = ProcessSnapshot::Column;
+  auto cpuTime = [](const ProcessSnapshot::Values& v) {
+    return v[static_cast<size_t>(Column::UserTime)] + v[static_cast<size_t>(Column::SystemTime)];
+  };
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(time - _ValuesTime).count();
+  auto& cpu = values[static_cast<size_t>(Column::Cpu)];
+  if (_ValuesTime != std::chrono::steady_clock::time_point() && elapsed > 0 && cpuTime(values) >= cpuTime(_Values)) {
+    cpu = (cpuTime(values) - cpuTime(_Values)) * 1000 * 1000 / elapsed;
+  } else {
+    cpu = 0;
   }
 
-  auto start = content.find_first_of('(');
-  auto end = content.find_last_of(')');
+  _Values = values;
+  _ValuesTime = time;
+}
 
-  std::istringstream beforeComm(content.substr(0, start));
-  std::istringstream afterComm(content.substr(end + 1, content.length() - (end + 1)));
+void Process::Publish() {
+  if (!_Pending.Exists || IsNewIncarnation(utils::JiffyToClock(_Pending.StartTime))) {
+    _Exists = false;
+    return;
+  }
 
-  beforeComm >> _Info.pid;
-  _Info.comm = content.substr(start, end - start + 1);
-  afterComm >> ps.state >> _Info.ppid >> ps.pgrp >> ps.session >> ps.tty_nr >> ps.tpgid >> ps.flags >> ps.minflt >>
-      ps.cminflt >> ps.majflt >> ps.cmajflt >> ps.utime >> ps.stime >> ps.cutime >> ps.cstime >> ps.priority >>
-      ps.nice >> ps.num_threads >> ps.itrealvalue >> ps.starttime >> ps.vsize >> ps.rss;
+  _Info.pid = _Pending.Info.pid;
+  _Info.ppid = _Pending.Info.ppid;
+  if (_Info.comm != _Pending.Info.comm) {
+    _Info.comm = _Pending.Info.comm;
+    _CommandLine.reset();
+  }
 
-  _StartTime = utils::JiffyToClock(ps.starttime);
-  _LastUpdate = std::chrono::steady_clock::now();
+  _StartTime = utils::JiffyToClock(_Pending.StartTime);
+  _LastUpdate = _Pending.Time;
   _Exists = true;
 
-  if (auto ptr = _State.lock()) {
-    ptr->SetValue(ps.state);
+  using Column = ProcessSnapshot::Column;
+  auto values = _Values;
+  values[static_cast<size_t>(Column::State)] = _Pending.State;
+  values[static_cast<size_t>(Column::Rss)] = _Pending.Mem;
+  values[static_cast<size_t>(Column::UserTime)] = _Pending.UserTime;
+  values[static_cast<size_t>(Column::SystemTime)] = _Pending.SystemTime;
+  for (size_t i = 0; i < _IoFields.size(); ++i) {
+    if (_Pending.HasIo[i]) {
+      values[static_cast<size_t>(Column::ReadBytes) + i] = _Pending.Io[i];
+    }
   }
+  SetValues(values, _Pending.Time);
 
-  if (auto ptr = _Mem.lock()) {
-    ptr->SetValue(ps.rss);
+  for (auto [member, value] : {
+           std::pair{&Process::_State, _Pending.State},
+           std::pair{&Process::_Mem, _Pending.Mem},
+           std::pair{&Process::_UserTime, _Pending.UserTime},
+           std::pair{&Process::_SystemTime, _Pending.SystemTime},
+       }) {
+    if (auto ptr = (this->*member).lock()) {
+      ptr->SetValue(value);
+    }
   }
 
-  if (auto ptr = _UserTime.lock()) {
-    ptr->SetValue(ps.utime);
+  for (size_t i = 0; i < StatFieldCount; ++i) {
+    if (auto ptr = _StatGauges[i].lock()) {
+      ptr->SetValue(_Pending.Stats[i]);
+    }
   }
 
-  if (auto ptr = _SystemTime.lock()) {
-    ptr->SetValue(ps.stime);
+  PublishMemory();
+
+  for (size_t i = 0; i < _IoFields.size(); ++i) {
+    if (!_Pending.HasIo[i]) {
+      continue;
+    }
+    if (auto ptr = (this->*_IoFields[i].Member).lock()) {
+      ptr->SetValue(_Pending.Io[i]);
+    }
   }
 }
 
-void Process::ParseIoFile() {
-  // Open the file
-  std::ifstream ifs(_ProcDirPath / "io");
-  if (!ifs.is_open()) {
+void Process::Update(const TaskSample& sample) {
+  if (IsNewIncarnation(utils::JiffyToClock(sample.starttime))) {
+    _Exists = false;
     return;
   }
 
-  // Read the file contents into a string
-  std::string content;
-  try {
-    content = std::string(std::istreambuf_iterator<char>(ifs), {});
-  } catch (const std::ios_base::failure& e) {
-    return;
+  std::string_view comm(sample.comm.data(), strnlen(sample.comm.data(), sample.comm.size()));
+
+  _Info.pid = sample.pid;
+  _Info.ppid = sample.ppid;
+  if (_Info.comm.size() != comm.size() + 2 || _Info.comm.compare(1, comm.size(), comm) != 0) {
+    _Info.comm.assign("(").append(comm).append(")");
+    _CommandLine.reset();
   }
 
-  for (const auto line : std::views::split(content, std::string_view{"\n"})) {
-    static std::regex pattern(std::string("^(\\w+):\\s+(\\d+)$"), std::regex::optimize);
+  _StartTime = utils::JiffyToClock(sample.starttime);
+  _LastUpdate = std::chrono::steady_clock::now();
+  _Exists = true;
 
-    std::match_results<decltype(line.begin())> match;
-    if (!std::regex_match(line.begin(), line.end(), match, pattern)) {
-      continue;
+  using Column = ProcessSnapshot::Column;
+  ProcessSnapshot::Values values{};
+  for (auto [column, member, value] : {
+           std::tuple{Column::State, &Process::_State, static_cast<metrics::DataType>(sample.state)},
+           std::tuple{Column::Rss, &Process::_Mem, static_cast<metrics::DataType>(sample.rss)},
+           std::tuple{Column::UserTime, &Process::_UserTime, static_cast<metrics::DataType>(sample.utime)},
+           std::tuple{Column::SystemTime, &Process::_SystemTime, static_cast<metrics::DataType>(sample.stime)},
+           std::tuple{Column::ReadBytes, &Process::_ReadBytes, sample.rchar},
+           std::tuple{Column::WriteBytes, &Process::_WriteBytes, sample.wchar},
+           std::tuple{Column::ReadCalls, &Process::_ReadCalls, sample.syscr},
+           std::tuple{Column::WriteCalls, &Process::_WriteCalls, sample.syscw},
+           std::tuple{Column::DiskReadBytes, &Process::_DiskReadBytes, sample.read_bytes},
+           std::tuple{Column::DiskWriteBytes, &Process::_DiskWriteBytes, sample.write_bytes},
+           std::tuple{Column::DiskCancelledWriteBytes, &Process::_DiskCancelledWriteBytes,
+                      sample.cancelled_write_bytes},
+       }) {
+    values[static_cast<size_t>(column)] = value;
+    if (auto ptr = (this->*member).lock()) {
+      ptr->SetValue(value);
     }
+  }
+  SetValues(values, _LastUpdate);
 
-    std::string key = match[1].str();
-    metrics::DataType value = std::stoll(match[2].str());
+  for (size_t i = 0; i < StatFieldCount; ++i) {
+    if (auto ptr = _StatGauges[i].lock()) {
+      ptr->SetValue(_StatFields[i].FromSample(sample));
+    }
+  }
 
-    if (key == "rchar") {
-      if (auto ptr = _ReadBytes.lock()) {
-        ptr->SetValue(value);
-      }
-    } else if (key == "wchar") {
-      if (auto ptr = _WriteBytes.lock()) {
-        ptr->SetValue(value);
-      }
-    } else if (key == "syscr") {
-      if (auto ptr = _ReadCalls.lock()) {
-        ptr->SetValue(value);
-      }
-    } else if (key == "syscw") {
-      if (auto ptr = _WriteCalls.lock()) {
-        ptr->SetValue(value);
-      }
-    } else if (key == "read_bytes") {
-      if (auto ptr = _DiskReadBytes.lock()) {
-        ptr->SetValue(value);
-      }
-    } else if (key == "write_bytes") {
-      if (auto ptr = _DiskWriteBytes.lock()) {
+  // The task iterator has no equivalent of smaps_rollup, read the files for the watched processes.
+  if (WantsMemory()) {
+    _Pending.HasMemory.reset();
+    SampleMemory();
+    PublishMemory();
+  }
+}
+
+void Process::Update(const TaskAccounting& accounting) {
+  if (accounting.delays) {
+    for (auto [member, value] : {
+             std::pair{&Process::_RunDelay, accounting.delays->run},
+             std::pair{&Process::_BlkioDelay, accounting.delays->blkio},
+             std::pair{&Process::_SwapinDelay, accounting.delays->swapin},
+         }) {
+      if (auto ptr = (this->*member).lock()) {
         ptr->SetValue(value);
       }
-    } else if (key == "cancelled_write_bytes") {
-      if (auto ptr = _DiskCancelledWriteBytes.lock()) {
+    }
+  }
+
+  if (accounting.io) {
+    _LastUpdate = std::chrono::steady_clock::now();
+
+    // The final record of a process. It is less precise than /proc and only covers the leader thread, so it may only
+    // add what happened since the last sample; a counter never goes backwards.
+    for (auto [member, value] : {
+             std::pair{&Process::_ReadBytes, accounting.io->rchar},
+             std::pair{&Process::_WriteBytes, accounting.io->wchar},
+             std::pair{&Process::_ReadCalls, accounting.io->syscr},
+             std::pair{&Process::_WriteCalls, accounting.io->syscw},
+             std::pair{&Process::_DiskReadBytes, accounting.io->read_bytes},
+             std::pair{&Process::_DiskWriteBytes, accounting.io->write_bytes},
+             std::pair{&Process::_DiskCancelledWriteBytes, accounting.io->cancelled_write_bytes},
+         }) {
+      if (auto ptr = (this->*member).lock(); ptr && value > ptr->GetValue()) {
         ptr->SetValue(value);
       }
     }
   }
 }
 
-std::shared_ptr<metrics::Gauge> Process::GetGauge(std::shared_ptr<Process> me, GaugeMember member) {
-  if (auto result = (me.get()->*member).lock()) {
+const std::string& Process::GetCommandLine() const {
+  if (_CommandLine) {
+    return *_CommandLine;
+  }
+
+  std::string result;
+  std::array<char, 1024> buffer;
+
+  auto gone = [] { return errno == ENOENT || errno == ESRCH; };
+  for (ssize_t bytes = PosixE(_Files.Read(ProcFiles::File::Cmdline, buffer), gone); bytes > 0;
+       bytes = PosixE(_Files.Read(ProcFiles::File::Cmdline, buffer, result.size()), gone)) {
+    result.append(buffer.data(), bytes);
+  }
+
+  // Kernel threads have none, and neither has a process that is gone; show the comm then.
+  _CommandLine = utils::StringPool::GetInstance().Intern(result.empty() ? _Info.comm : result);
+  return *_CommandLine;
+}
+
+void Process::ParseStatFile(std::string_view content) {
+  ProcessStat ps;
+  if (!StatParser::Parse(content, ps)) {
+    return;
+  }
+
+  _Pending.Info.pid = ps.pid;
+  _Pending.Info.ppid = ps.ppid;
+  if (_Pending.Info.comm != ps.comm) {
+    _Pending.Info.comm.assign(ps.comm);
+  }
+
+  _Pending.StartTime = ps.starttime;
+  _Pending.Time = std::chrono::steady_clock::now();
+  _Pending.State = ps.state;
+  _Pending.Mem = ps.rss;
+  _Pending.UserTime = ps.utime;
+  _Pending.SystemTime = ps.stime;
+  for (size_t i = 0; i < StatFieldCount; ++i) {
+    _Pending.Stats[i] = _StatFields[i].FromStat(ps);
+  }
+  _Pending.Exists = true;
+}
+
+const std::array<Process::StatFieldSource, Process::StatFieldCount> Process::_StatFields{{
+    MakeStatFieldSource<&ProcessStat::minflt, &TaskSample::minflt, StatKind::Counter>(),
+    MakeStatFieldSource<&ProcessStat::cminflt, &TaskSample::cminflt, StatKind::Counter>(),
+    MakeStatFieldSource<&ProcessStat::majflt, &TaskSample::majflt, StatKind::Counter>(),
+    MakeStatFieldSource<&ProcessStat::cmajflt, &TaskSample::cmajflt, StatKind::Counter>(),
+    MakeStatFieldSource<&ProcessStat::priority, &TaskSample::priority, StatKind::SignedLevel>(),
+    MakeStatFieldSource<&ProcessStat::nice, &TaskSample::nice, StatKind::SignedLevel>(),
+    MakeStatFieldSource<&ProcessStat::num_threads, &TaskSample::num_threads, StatKind::Level>(),
+    MakeStatFieldSource<&ProcessStat::vsize, &TaskSample::vsize, StatKind::Level>(),
+    MakeStatFieldSource<&ProcessStat::pgrp, &TaskSample::pgrp, StatKind::Level>(),
+    MakeStatFieldSource<&ProcessStat::session, &TaskSample::session, StatKind::Level>(),
+    MakeStatFieldSource<&ProcessStat::tty_nr, &TaskSample::tty_nr, StatKind::Level>(),
+    MakeStatFieldSource<&ProcessStat::tpgid, &TaskSample::tpgid, StatKind::SignedLevel>(),
+    MakeStatFieldSource<&ProcessStat::flags, &TaskSample::flags, StatKind::Level>(),
+    MakeStatFieldSource<&ProcessStat::cutime, &TaskSample::cutime, StatKind::Counter>(),
+    MakeStatFieldSource<&ProcessStat::cstime, &TaskSample::cstime, StatKind::Counter>(),
+    MakeStatFieldSource<&ProcessStat::itrealvalue, &TaskSample::itrealvalue, StatKind::Level>(),
+}};
+
+const std::array<Process::MemoryKey, 4> Process::_StatusKeys{{
+    {"RssAnon:", MemoryField::Anon},
+    {"RssFile:", MemoryField::File},
+    {"RssShmem:", MemoryField::Shmem},
+    {"VmSwap:", MemoryField::Swap},
+}};
+
+const std::array<Process::MemoryKey, 4> Process::_SmapsKeys{{
+    {"Pss:", MemoryField::Pss},
+    {"Private_Clean:", MemoryField::Uss},
+    {"Private_Dirty:", MemoryField::Uss},
+    {"Private_Hugetlb:", MemoryField::Uss},
+}};
+
+const std::array<Process::IoField, 7> Process::_IoFields{{
+    {"rchar:", &Process::_ReadBytes},
+    {"wchar:", &Process::_WriteBytes},
+    {"syscr:", &Process::_ReadCalls},
+    {"syscw:", &Process::_WriteCalls},
+    {"read_bytes:", &Process::_DiskReadBytes},
+    {"write_bytes:", &Process::_DiskWriteBytes},
+    {"cancelled_write_bytes:", &Process::_DiskCancelledWriteBytes},
+}};
+
+bool Process::IsWatched() const {
+  return std::ranges::any_of(
+      std::array{&Process::_State, &Process::_Mem, &Process::_UserTime, &Process::_SystemTime, &Process::_RunDelay,
+                 &Process::_BlkioDelay, &Process::_SwapinDelay},
+      [this](GaugeMember member) { return !(this->*member).expired(); }) ||
+         std::ranges::any_of(_StatGauges, [](auto& gauge) { return !gauge.expired(); }) || WantsIo() ||
+         WantsMemory();
+}
+
+bool Process::WantsMemory() const {
+  return std::ranges::any_of(_MemoryGauges, [](auto& gauge) { return !gauge.expired(); });
+}
+
+bool Process::WantsIo() const {
+  // The io file is comparatively expensive to generate, don't read it if nobody is watching. Gauges are only created on
+  // the metrics thread, which waits for sampling to finish, so the weak pointers are stable here.
+  return !std::ranges::all_of(_IoFields, [this](const IoField& field) { return (this->*field.Member).expired(); });
+}
+
+void Process::ParseIoFile(std::string_view content) {
+  utils::FieldParser parser(content);
+  std::string_view key;
+  metrics::DataType value;
+  while (parser.Next(key) && parser.Next(value)) {
+    auto field = std::ranges::find(_IoFields, key, &IoField::Key);
+    if (field == _IoFields.end()) {
+      continue;
+    }
+
+    auto index = field - _IoFields.begin();
+    _Pending.Io[index] = value;
+    _Pending.HasIo.set(index);
+  }
+}
+
+std::shared_ptr<metrics::Gauge> Process::GetGauge(std::shared_ptr<Process> me, std::weak_ptr<ProcessGauge>& gauge) {
+  if (auto result = gauge.lock()) {
     return result;
   } else {
-    result = std::make_shared<ProcessGauge>(me);
-    (me.get()->*member) = result;
+    result = utils::MakePooled<ProcessGauge>(me, me->IsCounter(gauge));
+    gauge = result;
     return result;
   }
 }
 
+bool Process::IsCounter(const std::weak_ptr<ProcessGauge>& gauge) const {
+  for (size_t i = 0; i < StatFieldCount; ++i) {
+    if (&gauge == &_StatGauges[i]) {
+      return _StatFields[i].Kind == StatKind::Counter;
+    }
+  }
+  return &gauge != &_State && &gauge != &_Mem &&
+         std::ranges::none_of(_MemoryGauges, [&](auto& memory) { return &gauge == &memory; });
+}
+
 } // namespace backend::process
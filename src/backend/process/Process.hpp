@@ -1,16 +1,29 @@
 #pragma once
 
-#include <filesystem>
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 
+#include "../../utils/StringPool.hpp"
 #include "../metrics/Gauge.hpp"
+#include "ProcFiles.hpp"
+#include "ProcessSnapshot.hpp"
+#include "StatParser.hpp"
+#include "TaskSample.hpp"
+#include "Taskstats.hpp"
 #include "Types.hpp"
+#include "UringReader.hpp"
 
 namespace backend::process {
 
 class Process {
 public:
-  explicit Process(const std::filesystem::path& dir) : _ProcDirPath(dir) {}
+  explicit Process(int dirFd, std::string_view name) : _Files(dirFd, name) {}
   ~Process() = default;
 
   using GaugePtr = std::shared_ptr<backend::metrics::Gauge>;
@@ -27,16 +40,89 @@ public:
   static GaugePtr GetDiskCancelledWriteBytes(std::shared_ptr<Process> me) {
     return me->GetGauge(me, &Process::_DiskCancelledWriteBytes);
   }
+  static GaugePtr GetRunDelay(std::shared_ptr<Process> me) { return me->GetGauge(me, &Process::_RunDelay); }
+  static GaugePtr GetBlkioDelay(std::shared_ptr<Process> me) { return me->GetGauge(me, &Process::_BlkioDelay); }
+  static GaugePtr GetSwapinDelay(std::shared_ptr<Process> me) { return me->GetGauge(me, &Process::_SwapinDelay); }
 
-  void Update();
+  // Further fields of /proc/<pid>/stat, in its units. Priority, Nice and TtyProcessGroup may be negative; their gauges
+  // hold the value offset by SignedOffset, so they still order as numbers. Read them through ToSigned.
+  enum class StatField {
+    MinorFaults,
+    ChildMinorFaults,
+    MajorFaults,
+    ChildMajorFaults,
+    Priority,
+    Nice,
+    Threads,
+    VirtualSize,
+    ProcessGroup,
+    Session,
+    Tty,
+    TtyProcessGroup,
+    Flags,
+    ChildUserTime,
+    ChildSystemTime,
+    IntervalTimer,
+    Count
+  };
+  static GaugePtr GetStatField(std::shared_ptr<Process> me, StatField field) {
+    return me->GetGauge(me, me->_StatGauges[static_cast<size_t>(field)]);
+  }
+  static constexpr metrics::DataType SignedOffset = metrics::DataType(1) << 63;
+  static constexpr int64_t ToSigned(metrics::DataType value) { return static_cast<int64_t>(value - SignedOffset); }
+
+  // Memory breakdown in bytes. Anon, File, Shmem and Swap come from /proc/<pid>/status and are read with every sample.
+  // Pss and Uss need /proc/<pid>/smaps_rollup, which walks the whole address space; it is read less often the longer
+  // it takes, see SmapsCostFactor.
+  enum class MemoryField { Pss, Uss, Swap, Anon, File, Shmem, Count };
+  static GaugePtr GetMemoryField(std::shared_ptr<Process> me, MemoryField field) {
+    return me->GetGauge(me, me->_MemoryGauges[static_cast<size_t>(field)]);
+  }
+  // Read smaps_rollup with every sample regardless of its cost, e.g. for the selected process.
+  void SetMemoryPriority(bool priority) { _MemoryPriority = priority; }
+
+  // Update is Sample followed by Publish. Sample only reads /proc/<pid> into a pending sample and may run on any
+  // thread, as long as a process is sampled by one thread at a time; Publish applies the pending sample and notifies
+  // the gauges, it must run on the thread that owns the metrics.
+  void Update() {
+    Sample();
+    Publish();
+  }
+  void Sample();
+  void Publish();
+
+  // Sample split around reads issued in bulk, e.g. through io_uring. PrepareSample fills `reads` with the reads of
+  // this process, skipped ones keep a negative descriptor, into `buffers`; CompleteSample parses their results.
+  struct SampleBuffers {
+    StatParser::Buffer Stat;
+    std::array<char, 512> Io;
+  };
+  void PrepareSample(std::span<BatchRead, 2> reads, SampleBuffers& buffers);
+  void CompleteSample(std::span<const BatchRead, 2> reads);
+  // Update from values collected in bulk, e.g. by the BPF task iterator, instead of reading /proc/<pid>.
+  void Update(const TaskSample& sample);
+  // Update from taskstats. Delay gauges are only fed from here.
+  void Update(const TaskAccounting& accounting);
 
   // Following APIs are only available after Update
   bool Exists() const { return _Exists; }
+  // Whether the pid was taken over by another process, told apart by its start time. A recycled object stops
+  // updating and doesn't exist any more; it must be replaced by a fresh one, so the gauges and rates of the old process
+  // don't carry over to the new one.
+  bool IsRecycled() const { return _Recycled; }
   PidType GetPid() const { return _Info.pid; }
   PidType GetPPid() const { return _Info.ppid; }
   std::string GetCommand() const { return _Info.comm; }
   std::chrono::steady_clock::time_point GetStartTime() const { return _StartTime; }
-  std::string GetCommandLine() const;
+  // The last sample, whether watched or not, for ProcessSnapshot.
+  const ProcessSnapshot::Values& GetValues() const { return _Values; }
+  // Read once and kept until the process execs: a new comm, or InvalidateCommandLine.
+  const std::string& GetCommandLine() const;
+  // For exec events, which may keep the comm, e.g. a shell running a script.
+  void InvalidateCommandLine() { _CommandLine.reset(); }
+  // Whether any gauge of this process is alive, i.e. somebody is looking at it.
+  bool IsWatched() const;
+  bool WantsAccounting() const { return !_RunDelay.expired() || !_BlkioDelay.expired() || !_SwapinDelay.expired(); }
 
 private:
   struct ProcessInfo {
@@ -45,14 +131,84 @@ private:
     std::string comm;
   };
 
-  void ParseStatFile();
-  void ParseIoFile();
+  static constexpr size_t StatFieldCount = static_cast<size_t>(StatField::Count);
+
+  // Whether the gauge of a StatField is a counter (see ProcessGauge), and whether it is offset by SignedOffset.
+  enum class StatKind { Counter, Level, SignedLevel };
+
+  // Where each StatField comes from, for either source, and its kind.
+  struct StatFieldSource {
+    metrics::DataType (*FromStat)(const ProcessStat& stat);
+    metrics::DataType (*FromSample)(const TaskSample& sample);
+    StatKind Kind;
+  };
+  template <StatKind Kind, typename T> static constexpr metrics::DataType EncodeStatField(T value) {
+    if constexpr (Kind == StatKind::SignedLevel) {
+      return static_cast<metrics::DataType>(static_cast<int64_t>(value)) + SignedOffset;
+    } else {
+      return static_cast<metrics::DataType>(value);
+    }
+  }
+  template <auto StatMember, auto SampleMember, StatKind Kind> static constexpr StatFieldSource MakeStatFieldSource() {
+    return {[](const ProcessStat& stat) { return EncodeStatField<Kind>(stat.*StatMember); },
+            [](const TaskSample& sample) { return EncodeStatField<Kind>(sample.*SampleMember); }, Kind};
+  }
+  static const std::array<StatFieldSource, StatFieldCount> _StatFields;
+
+  static constexpr size_t MemoryFieldCount = static_cast<size_t>(MemoryField::Count);
+
+  // Maps keys of /proc/<pid>/status and smaps_rollup to memory fields. Several keys may add up to one field.
+  struct MemoryKey {
+    std::string_view Key;
+    MemoryField Field;
+  };
+  static const std::array<MemoryKey, 4> _StatusKeys;
+  static const std::array<MemoryKey, 4> _SmapsKeys;
+
+  // smaps_rollup is read again after SmapsCostFactor times its last cost, i.e. it may take at most 1 / SmapsCostFactor
+  // of the time, but at least every SmapsMaxInterval while watched.
+  static constexpr unsigned SmapsCostFactor = 100;
+  static constexpr std::chrono::seconds SmapsMaxInterval{30};
+
+  // Everything Sample collects for Publish.
+  struct PendingSample {
+    bool Exists = false;
+    ProcessInfo Info;
+    unsigned long long StartTime;
+    std::chrono::steady_clock::time_point Time;
+    metrics::DataType State;
+    metrics::DataType Mem;
+    metrics::DataType UserTime;
+    metrics::DataType SystemTime;
+    std::array<metrics::DataType, StatFieldCount> Stats;
+    std::bitset<MemoryFieldCount> HasMemory;
+    std::array<metrics::DataType, MemoryFieldCount> Memory;
+    std::bitset<7> HasIo;
+    std::array<metrics::DataType, 7> Io;
+  };
+
+  bool WantsIo() const;
+  bool WantsMemory() const;
+  void SampleMemory();
+  void PublishMemory();
+  bool IsNewIncarnation(std::chrono::steady_clock::time_point start);
+  // Keeps `values` of a sample taken at `time` for GetValues, with the Cpu column derived from the previous ones.
+  void SetValues(ProcessSnapshot::Values values, std::chrono::steady_clock::time_point time);
+  bool ParseMemoryFile(ProcFiles::File file, std::span<const MemoryKey> keys);
+  void ParseStatFile(std::string_view content);
+  void ParseIoFile(std::string_view content);
 
   class ProcessGauge : public metrics::Gauge {
   public:
-    explicit ProcessGauge(std::shared_ptr<Process> owner) : _Owner(owner), _Value(0), _First(true) {}
+    explicit ProcessGauge(std::shared_ptr<Process> owner, bool counter)
+        : _Owner(owner), _Value(0), _First(true), _Counter(counter) {}
 
+    // A level that didn't change is not notified. A counter always is: CounterSlice needs every sample to see a rate
+    // drop to zero.
     void SetValue(metrics::DataType value) {
+      if (!_Counter && !_First && value == _Value) {
+        return;
+      }
       _Value = value;
       _First = false;
       Notify();
@@ -72,23 +228,46 @@ private:
     std::shared_ptr<Process> _Owner;
     metrics::DataType _Value;
     bool _First;
+    const bool _Counter;
   };
 
   using GaugeMember = std::weak_ptr<ProcessGauge> Process::*;
-  static std::shared_ptr<metrics::Gauge> GetGauge(std::shared_ptr<Process> me, GaugeMember member);
+  static std::shared_ptr<metrics::Gauge> GetGauge(std::shared_ptr<Process> me, GaugeMember member) {
+    return GetGauge(me, me.get()->*member);
+  }
+  static std::shared_ptr<metrics::Gauge> GetGauge(std::shared_ptr<Process> me, std::weak_ptr<ProcessGauge>& gauge);
+  bool IsCounter(const std::weak_ptr<ProcessGauge>& gauge) const;
+
+  // Maps the keys of /proc/<pid>/io to the gauges they feed.
+  struct IoField {
+    std::string_view Key;
+    GaugeMember Member;
+  };
+  static const std::array<IoField, 7> _IoFields;
 
-  const std::filesystem::path _ProcDirPath;
+  mutable ProcFiles _Files;
+  PendingSample _Pending;
   std::chrono::steady_clock::time_point _LastUpdate;
   bool _Exists = false;
+  bool _Recycled = false;
 
   ProcessInfo _Info;
   std::chrono::steady_clock::time_point _StartTime;
+  ProcessSnapshot::Values _Values{};
+  std::chrono::steady_clock::time_point _ValuesTime;
+  mutable utils::StringPool::Handle _CommandLine;
 
   // Metrics from stat file
   std::weak_ptr<ProcessGauge> _State;
   std::weak_ptr<ProcessGauge> _Mem;
   std::weak_ptr<ProcessGauge> _UserTime;
   std::weak_ptr<ProcessGauge> _SystemTime;
+  std::array<std::weak_ptr<ProcessGauge>, StatFieldCount> _StatGauges;
+
+  // Metrics from status and smaps_rollup files
+  std::array<std::weak_ptr<ProcessGauge>, MemoryFieldCount> _MemoryGauges;
+  bool _MemoryPriority = false;
+  std::chrono::steady_clock::time_point _SmapsDue;
 
   // Metrics from io file
   std::weak_ptr<ProcessGauge> _ReadBytes;
@@ -98,6 +277,11 @@ private:
   std::weak_ptr<ProcessGauge> _DiskReadBytes;
   std::weak_ptr<ProcessGauge> _DiskWriteBytes;
   std::weak_ptr<ProcessGauge> _DiskCancelledWriteBytes;
+
+  // Metrics from taskstats, in nanoseconds
+  std::weak_ptr<ProcessGauge> _RunDelay;
+  std::weak_ptr<ProcessGauge> _BlkioDelay;
+  std::weak_ptr<ProcessGauge> _SwapinDelay;
 };
 
 } // namespace backend::process
\ No newline at end of file
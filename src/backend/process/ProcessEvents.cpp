@@ -0,0 +1,118 @@
+#include "ProcessEvents.hpp"
+
+#include <array>
+#include <charconv>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "../../utils/Error.hpp"
+
+namespace backend::process {
+
+int ProcessEvents::Open() {
+  int fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+  if (fd < 0) {
+    return -1;
+  }
+
+  auto fail = [fd] {
+    int err = errno;
+    close(fd);
+    errno = err;
+    return -1;
+  };
+
+  struct sockaddr_nl address = {};
+  address.nl_family = AF_NETLINK;
+  address.nl_groups = CN_IDX_PROC;
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) < 0) {
+    return fail();
+  }
+
+  alignas(struct nlmsghdr) std::array<char, NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))>
+      request = {};
+  auto header = reinterpret_cast<struct nlmsghdr*>(request.data());
+  header->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op));
+  header->nlmsg_type = NLMSG_DONE;
+  header->nlmsg_pid = getpid();
+  auto message = static_cast<struct cn_msg*>(NLMSG_DATA(header));
+  message->id.idx = CN_IDX_PROC;
+  message->id.val = CN_VAL_PROC;
+  message->len = sizeof(enum proc_cn_mcast_op);
+  *reinterpret_cast<enum proc_cn_mcast_op*>(message->data) = PROC_CN_MCAST_LISTEN;
+  if (send(fd, request.data(), header->nlmsg_len, 0) < 0) {
+    return fail();
+  }
+
+  return fd;
+}
+
+void ProcessEvents::Receive(int fd) {
+  alignas(struct nlmsghdr) std::array<char, 8192> buffer;
+  while (true) {
+    ssize_t bytes = recv(fd, buffer.data(), buffer.size(), 0);
+    if (bytes < 0) {
+      if (errno == ENOBUFS) {
+        // The kernel dropped events, only a full scan can tell what we missed.
+        _RescanNeeded = true;
+        continue;
+      } else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return;
+      }
+      throw std::system_error(errno, std::generic_category());
+    }
+
+    auto header = reinterpret_cast<struct nlmsghdr*>(buffer.data());
+    for (int remaining = bytes; NLMSG_OK(header, remaining); header = NLMSG_NEXT(header, remaining)) {
+      if (header->nlmsg_type == NLMSG_NOOP || header->nlmsg_type == NLMSG_ERROR) {
+        continue;
+      }
+
+      auto message = static_cast<struct cn_msg*>(NLMSG_DATA(header));
+      if (message->id.idx != CN_IDX_PROC || message->id.val != CN_VAL_PROC) {
+        continue;
+      }
+
+      auto event = reinterpret_cast<struct proc_event*>(message->data);
+      switch (event->what) {
+      case proc_event::PROC_EVENT_FORK:
+        // Threads are reported as forks too, only new thread groups are new processes.
+        if (event->event_data.fork.child_pid == event->event_data.fork.child_tgid) {
+          OnNewProcess(event->event_data.fork.child_tgid);
+        }
+        break;
+      case proc_event::PROC_EVENT_EXEC:
+        _Callback.OnExec(event->event_data.exec.process_tgid);
+        break;
+      case proc_event::PROC_EVENT_EXIT:
+        if (event->event_data.exit.process_pid == event->event_data.exit.process_tgid) {
+          _Callback.OnExit(event->event_data.exit.process_tgid);
+        }
+        break;
+      default:
+        break;
+      }
+    }
+  }
+}
+
+bool ProcessEvents::DoIterate() {
+  if (!_RescanNeeded) {
+    return false;
+  }
+  _RescanNeeded = false;
+  _Listing.DoIterate();
+  return true;
+}
+
+void ProcessEvents::OnNewProcess(PidType pid) {
+  std::array<char, 16> name;
+  auto [end, ec] = std::to_chars(name.data(), name.data() + name.size() - 1, pid);
+  *end = '\0';
+  _Callback(pid, _Listing.GetProcFd(), {name.data(), static_cast<size_t>(end - name.data())});
+}
+
+} // namespace backend::process
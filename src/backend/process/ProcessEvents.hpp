@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ProcessListing.hpp"
+
+namespace backend::process {
+
+// Process listing driven by fork/exec/exit events of the kernel proc connector (cn_proc). The full /proc scan only
+// runs initially and after the socket overflowed, since events may have been lost then.
+class ProcessEvents {
+public:
+  explicit ProcessEvents(ProcessListing& listing, ProcessListingCallback& callback)
+      : _Listing(listing), _Callback(callback) {}
+  ~ProcessEvents() = default;
+
+  ProcessEvents(const ProcessEvents&) = delete;
+  ProcessEvents(ProcessEvents&&) = delete;
+  ProcessEvents& operator=(const ProcessEvents&) = delete;
+  ProcessEvents& operator=(ProcessEvents&&) = delete;
+
+  // Returns a non-blocking netlink socket subscribed to proc events, or -1 with errno set. Subscribing needs
+  // CAP_NET_ADMIN in the initial user namespace.
+  static int Open();
+
+  // Drains all pending events from `fd`.
+  void Receive(int fd);
+  // Scans /proc if needed. Returns whether it did.
+  bool DoIterate();
+
+private:
+  void OnNewProcess(PidType pid);
+
+  ProcessListing& _Listing;
+  ProcessListingCallback& _Callback;
+  bool _RescanNeeded = true;
+};
+
+} // namespace backend::process
@@ -1,36 +1,58 @@
 #include "ProcessListing.hpp"
 
-#include <ranges>
-
-#include "Process.hpp"
+#include <array>
+#include <dirent.h>
+#include <fcntl.h>
+#include <format>
+#include <unistd.h>
 
 namespace backend::process {
 
-const std::filesystem::path ProcessListing::_ProcPath{"/proc"};
+ProcessListing::ProcessListing(ProcessListingCallback& callback)
+    : _Callback(callback), _ProcFd(PosixE(open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC))) {}
+
+ProcessListing::ProcessListing(ProcessListingCallback& callback, int procFd, PidType pid)
+    : _Callback(callback),
+      _ProcFd(PosixE(openat(procFd, std::format("{}/task", pid).c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC))) {}
 
 void ProcessListing::DoIterate() {
-  for (auto& dir : std::filesystem::directory_iterator(_ProcPath)) {
-    if (Skip(dir)) {
-      continue;
+  PosixE(lseek(_ProcFd, 0, SEEK_SET));
+
+  alignas(struct dirent64) std::array<char, 32768> buffer;
+  for (ssize_t bytes = PosixE(getdents64(_ProcFd, buffer.data(), buffer.size())); bytes > 0;
+       bytes = PosixE(getdents64(_ProcFd, buffer.data(), buffer.size()))) {
+    for (ssize_t offset = 0; offset < bytes;) {
+      auto entry = reinterpret_cast<const struct dirent64*>(buffer.data() + offset);
+      offset += entry->d_reclen;
+
+      // procfs always fills d_type, so no stat is needed to tell pid directories from files.
+      if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN) {
+        continue;
+      }
+
+      PidType pid;
+      if (!ParsePid(entry->d_name, pid)) {
+        continue;
+      }
+
+      _Callback(pid, _ProcFd, entry->d_name);
     }
-
-    _Callback(PeekPid(dir), dir);
   }
 }
 
-PidType ProcessListing::PeekPid(const std::filesystem::path& path) { return std::stoi(path.filename().string()); }
-
-bool ProcessListing::Skip(const std::filesystem::directory_entry& entry) {
-  if (!entry.is_directory()) {
-    return true;
+bool ProcessListing::ParsePid(const char* name, PidType& pid) {
+  if (*name == '\0') {
+    return false;
   }
 
-  std::string filename = entry.path().filename();
-  if (!std::all_of(filename.begin(), filename.end(), ::isdigit)) {
-    return true;
+  pid = 0;
+  for (; *name != '\0'; ++name) {
+    if (*name < '0' || *name > '9') {
+      return false;
+    }
+    pid = pid * 10 + (*name - '0');
   }
-
-  return false;
+  return true;
 }
 
-} // namespace backend::process
\ No newline at end of file
+} // namespace backend::process
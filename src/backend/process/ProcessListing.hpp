@@ -1,11 +1,8 @@
 #pragma once
 
-#include <filesystem>
-#include <list>
-#include <memory>
-#include <unordered_map>
-#include <vector>
+#include <string_view>
 
+#include "../../utils/Error.hpp"
 #include "Types.hpp"
 
 namespace backend::process {
@@ -15,22 +12,29 @@ class Process;
 class ProcessListingCallback {
 public:
   virtual ~ProcessListingCallback() = default;
-  virtual void operator()(PidType pid, const std::filesystem::path& dir) = 0;
+  // `name` is relative to `dirFd`, which stays open as long as the listing lives.
+  virtual void operator()(PidType pid, int dirFd, std::string_view name) = 0;
+  // Only reported by event driven listings.
+  virtual void OnExec(PidType pid) {}
+  virtual void OnExit(PidType pid) {}
 };
 
 class ProcessListing {
 public:
-  explicit ProcessListing(ProcessListingCallback& callback) : _Callback(callback) {}
+  explicit ProcessListing(ProcessListingCallback& callback);
+  // Lists the threads of `pid` from /proc/<pid>/task instead, `procFd` is /proc. Throws std::system_error when the
+  // process is gone.
+  explicit ProcessListing(ProcessListingCallback& callback, int procFd, PidType pid);
   ~ProcessListing() = default;
 
   void DoIterate();
+  int GetProcFd() const { return _ProcFd; }
 
 private:
-  static PidType PeekPid(const std::filesystem::path& path);
-  static bool Skip(const std::filesystem::directory_entry& entry);
-  static const std::filesystem::path _ProcPath;
+  static bool ParsePid(const char* name, PidType& pid);
 
   ProcessListingCallback& _Callback;
+  utils::FileHandle _ProcFd;
 };
 
 } // namespace backend::process
@@ -0,0 +1,141 @@
+#include "ProcessSnapshot.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace backend::process {
+
+void ProcessSnapshot::Clear() {
+  _Pids.clear();
+  _ParentPids.clear();
+  for (auto& column : _Columns) {
+    column.clear();
+  }
+}
+
+ProcessSnapshot::Slot ProcessSnapshot::Add(PidType pid, PidType parent, const Values& values) {
+  Slot slot = static_cast<Slot>(_Pids.size());
+  _Pids.push_back(pid);
+  _ParentPids.push_back(parent);
+  for (size_t i = 0; i < ColumnCount; ++i) {
+    _Columns[i].push_back(values[i]);
+  }
+  return slot;
+}
+
+void ProcessSnapshot::Finish() {
+  _ByPid.resize(Size());
+  std::iota(_ByPid.begin(), _ByPid.end(), 0);
+  std::ranges::sort(_ByPid, {}, [this](Slot slot) { return _Pids[slot]; });
+
+  LinkParents();
+  ComputeTreeOrder();
+}
+
+ProcessSnapshot::Slot ProcessSnapshot::Find(PidType pid) const {
+  auto it = std::ranges::lower_bound(_ByPid, pid, {}, [this](Slot slot) { return _Pids[slot]; });
+  return it != _ByPid.end() && _Pids[*it] == pid ? *it : NoSlot;
+}
+
+void ProcessSnapshot::LinkParents() {
+  size_t size = Size();
+  _Parents.resize(size);
+  for (Slot slot = 0; slot < size; ++slot) {
+    Slot parent = Find(_ParentPids[slot]);
+    _Parents[slot] = parent == slot ? NoSlot : parent;
+  }
+
+  // Counting sort by parent, with the roots as children of a virtual slot `size`. Filling in pid order keeps every
+  // list of children sorted by pid.
+  _FirstChild.assign(size + 2, 0);
+  for (Slot parent : _Parents) {
+    ++_FirstChild[(parent == NoSlot ? size : parent) + 1];
+  }
+  std::partial_sum(_FirstChild.begin(), _FirstChild.end(), _FirstChild.begin());
+
+  _Children.resize(size);
+  std::vector<Slot> next(_FirstChild.begin(), _FirstChild.end() - 1);
+  for (Slot slot : _ByPid) {
+    Slot parent = _Parents[slot];
+    _Children[next[parent == NoSlot ? size : parent]++] = slot;
+  }
+}
+
+void ProcessSnapshot::ComputeTreeOrder() {
+  size_t size = Size();
+  _TreeOrder.clear();
+  _TreeOrder.reserve(size);
+  _TreePositions.assign(size, NoSlot);
+
+  std::vector<Slot> stack;
+  auto visit = [&](Slot first, Slot last) {
+    // Pushed in reverse, so the lowest pid is popped first.
+    for (Slot i = last; i > first; --i) {
+      stack.push_back(_Children[i - 1]);
+    }
+    while (!stack.empty()) {
+      Slot slot = stack.back();
+      stack.pop_back();
+      if (_TreePositions[slot] != NoSlot) {
+        continue;
+      }
+      _TreePositions[slot] = static_cast<Slot>(_TreeOrder.size());
+      _TreeOrder.push_back(slot);
+      for (Slot i = _FirstChild[slot + 1]; i > _FirstChild[slot]; --i) {
+        stack.push_back(_Children[i - 1]);
+      }
+    }
+  };
+
+  visit(_FirstChild[size], _FirstChild[size + 1]);
+
+  // Parent links racing with a refresh may form a cycle, which no root reaches. Put those last rather than lose them.
+  if (_TreeOrder.size() < size) {
+    for (Slot slot : _ByPid) {
+      if (_TreePositions[slot] == NoSlot) {
+        stack.push_back(slot);
+        visit(0, 0);
+      }
+    }
+  }
+}
+
+void ProcessSnapshot::FillSortKeys(Column column) const {
+  auto values = GetColumn(column);
+  _SortKeys.resize(values.size());
+  for (Slot slot = 0; slot < values.size(); ++slot) {
+    _SortKeys[slot] = {values[slot], _Pids[slot], slot};
+  }
+}
+
+namespace {
+
+struct Larger {
+  template <typename Key> bool operator()(const Key& a, const Key& b) const {
+    return a.Value != b.Value ? a.Value > b.Value : a.Pid < b.Pid;
+  }
+};
+
+} // namespace
+
+void ProcessSnapshot::Sort(Column column, std::vector<Slot>& result) const {
+  FillSortKeys(column);
+  std::ranges::sort(_SortKeys, Larger());
+  result.resize(_SortKeys.size());
+  std::ranges::transform(_SortKeys, result.begin(), &SortKey::Index);
+}
+
+void ProcessSnapshot::TopK(Column column, size_t k, std::vector<Slot>& result) const {
+  FillSortKeys(column);
+  k = std::min(k, _SortKeys.size());
+  std::ranges::partial_sort(_SortKeys, _SortKeys.begin() + k, Larger());
+  result.resize(k);
+  std::ranges::transform(std::span(_SortKeys).first(k), result.begin(), &SortKey::Index);
+}
+
+metrics::DataType ProcessSnapshot::Sum(Column column) const {
+  auto values = GetColumn(column);
+  return std::reduce(values.begin(), values.end(), metrics::DataType(0));
+}
+
+} // namespace backend::process
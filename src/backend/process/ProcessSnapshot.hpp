@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <stdint.h>
+#include <vector>
+
+#include "../metrics/DateType.hpp"
+#include "Types.hpp"
+
+namespace backend::process {
+
+// The processes of one refresh, one array per column, indexed by a dense slot. Ordering and aggregating walk these
+// arrays instead of chasing a pointer per process.
+class ProcessSnapshot {
+public:
+  using Slot = uint32_t;
+  static constexpr Slot NoSlot = UINT32_MAX;
+
+  // In the units of the gauges, but Cpu: the user and system time over the last sampling interval, in jiffies per
+  // 1000 s. The io columns follow /proc/<pid>/io and stay zero until the io file is read.
+  enum class Column {
+    State,
+    Rss,
+    UserTime,
+    SystemTime,
+    Cpu,
+    ReadBytes,
+    WriteBytes,
+    ReadCalls,
+    WriteCalls,
+    DiskReadBytes,
+    DiskWriteBytes,
+    DiskCancelledWriteBytes,
+    Count
+  };
+  static constexpr size_t ColumnCount = static_cast<size_t>(Column::Count);
+  using Values = std::array<metrics::DataType, ColumnCount>;
+
+  ProcessSnapshot() = default;
+  ~ProcessSnapshot() = default;
+
+  ProcessSnapshot(const ProcessSnapshot&) = delete;
+  ProcessSnapshot(ProcessSnapshot&&) = delete;
+  ProcessSnapshot& operator=(const ProcessSnapshot&) = delete;
+  ProcessSnapshot& operator=(ProcessSnapshot&&) = delete;
+
+  // Keeps the capacity, so rebuilding on every refresh doesn't allocate once the process count settles.
+  void Clear();
+  // `parent` is the pid of the row this one is shown under, e.g. the ppid, or the tgid of a thread. Pids are unique.
+  Slot Add(PidType pid, PidType parent, const Values& values);
+  // Links parents and computes the tree order. Must be called after the last Add and before the queries below.
+  void Finish();
+
+  size_t Size() const { return _Pids.size(); }
+  Slot Find(PidType pid) const;
+
+  std::span<const PidType> GetPids() const { return _Pids; }
+  std::span<const PidType> GetParentPids() const { return _ParentPids; }
+  std::span<const metrics::DataType> GetColumn(Column column) const { return _Columns[static_cast<size_t>(column)]; }
+
+  // Slots in depth-first order of the tree, siblings by pid, and the position of each slot in it.
+  std::span<const Slot> GetTreeOrder() const { return _TreeOrder; }
+  size_t GetTreePosition(Slot slot) const { return _TreePositions[slot]; }
+
+  // All slots into `result`, largest value of `column` first; ties go to the lower pid.
+  void Sort(Column column, std::vector<Slot>& result) const;
+  // The first `k` slots of Sort, without ordering the rest.
+  void TopK(Column column, size_t k, std::vector<Slot>& result) const;
+  // Slots whose value of `column` satisfies `predicate` into `result`, by slot. Every slot is written and only kept by
+  // advancing past it, so the loop has no branch on the predicate.
+  template <typename Predicate> void Filter(Column column, Predicate predicate, std::vector<Slot>& result) const {
+    auto values = GetColumn(column);
+    result.resize(values.size());
+    size_t count = 0;
+    for (Slot slot = 0; slot < values.size(); ++slot) {
+      result[count] = slot;
+      count += predicate(values[slot]) ? 1 : 0;
+    }
+    result.resize(count);
+  }
+  metrics::DataType Sum(Column column) const;
+
+private:
+  // What Sort and TopK order, copied out of the columns into one contiguous array.
+  struct SortKey {
+    metrics::DataType Value;
+    PidType Pid;
+    Slot Index;
+  };
+
+  void LinkParents();
+  void ComputeTreeOrder();
+  void FillSortKeys(Column column) const;
+
+  std::vector<PidType> _Pids;
+  std::vector<PidType> _ParentPids;
+  std::array<std::vector<metrics::DataType>, ColumnCount> _Columns;
+
+  // Built by Finish.
+  std::vector<Slot> _ByPid;
+  std::vector<Slot> _Parents;
+  // Children of slot s are _Children[_FirstChild[s] .. _FirstChild[s + 1]), by pid.
+  std::vector<Slot> _FirstChild;
+  std::vector<Slot> _Children;
+  std::vector<Slot> _TreeOrder;
+  std::vector<Slot> _TreePositions;
+
+  // Scratch of Sort and TopK, kept to reuse its capacity.
+  mutable std::vector<SortKey> _SortKeys;
+};
+
+} // namespace backend::process
@@ -0,0 +1,36 @@
+#include "SamplingPlanner.hpp"
+
+#include <algorithm>
+
+namespace backend::process {
+
+SamplingPlanner::SamplingPlanner(unsigned slowRatio)
+    : _SlowRatio(std::max(slowRatio, 1u)), _FastSampled(std::make_shared<metrics::SimpleGauge>(0)),
+      _SlowSampled(std::make_shared<metrics::SimpleGauge>(0)), _SavedReads(std::make_shared<metrics::SimpleGauge>(0)) {}
+
+void SamplingPlanner::BeginRound() {
+  ++_Round;
+  _Fast = 0;
+  _Slow = 0;
+}
+
+bool SamplingPlanner::IsDue(const Process& process, bool forced) {
+  if (forced || !process.Exists() || process.IsWatched()) {
+    ++_Fast;
+    return true;
+  } else if ((_Round + process.GetPid()) % _SlowRatio == 0) {
+    ++_Slow;
+    return true;
+  } else {
+    ++_Saved;
+    return false;
+  }
+}
+
+void SamplingPlanner::EndRound() {
+  _FastSampled->Update(_Fast);
+  _SlowSampled->Update(_Slow);
+  _SavedReads->Update(_Saved);
+}
+
+} // namespace backend::process
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+#include <stdint.h>
+
+#include "../metrics/Gauge.hpp"
+#include "Process.hpp"
+
+namespace backend::process {
+
+// Decides which processes are read on a refresh. Processes with live gauges, i.e. the rows on screen and anything
+// else somebody subscribed to, are in the fast tier and read on every refresh. The others are in the slow tier and
+// read on every `slowRatio`-th refresh, spread evenly over the refreshes by pid.
+class SamplingPlanner {
+public:
+  explicit SamplingPlanner(unsigned slowRatio);
+  ~SamplingPlanner() = default;
+
+  SamplingPlanner(const SamplingPlanner&) = delete;
+  SamplingPlanner(SamplingPlanner&&) = delete;
+  SamplingPlanner& operator=(const SamplingPlanner&) = delete;
+  SamplingPlanner& operator=(SamplingPlanner&&) = delete;
+
+  void BeginRound();
+  // `forced` puts the process in the fast tier regardless, e.g. when it is suspected to be gone.
+  bool IsDue(const Process& process, bool forced);
+  void EndRound();
+
+  // Processes read in the last round, per tier.
+  std::shared_ptr<metrics::Gauge> GetFastSampled() const { return _FastSampled; }
+  std::shared_ptr<metrics::Gauge> GetSlowSampled() const { return _SlowSampled; }
+  // Reads not done since start, a counter. An unwatched process never reads its io file, so skipping it saves the
+  // read of its stat file.
+  std::shared_ptr<metrics::Gauge> GetSavedReads() const { return _SavedReads; }
+
+private:
+  const unsigned _SlowRatio;
+  uint64_t _Round = 0;
+  uint64_t _Fast = 0;
+  uint64_t _Slow = 0;
+  uint64_t _Saved = 0;
+
+  std::shared_ptr<metrics::SimpleGauge> _FastSampled;
+  std::shared_ptr<metrics::SimpleGauge> _SlowSampled;
+  std::shared_ptr<metrics::SimpleGauge> _SavedReads;
+};
+
+} // namespace backend::process
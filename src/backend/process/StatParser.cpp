@@ -0,0 +1,29 @@
+#include "StatParser.hpp"
+
+#include "../../utils/FieldParser.hpp"
+
+namespace backend::process {
+
+bool StatParser::Parse(std::string_view content, ProcessStat& stat) {
+  // comm may contain spaces and parentheses, so it spans from the first '(' to the last ')'.
+  auto start = content.find('(');
+  auto end = content.rfind(')');
+  if (start == std::string_view::npos || end == std::string_view::npos || end < start) {
+    return false;
+  }
+
+  utils::FieldParser beforeComm(content.substr(0, start));
+  if (!beforeComm.Next(stat.pid)) {
+    return false;
+  }
+
+  stat.comm = content.substr(start, end - start + 1);
+
+  utils::FieldParser afterComm(content.substr(end + 1));
+  return afterComm.NextAll(stat.state, stat.ppid, stat.pgrp, stat.session, stat.tty_nr, stat.tpgid, stat.flags,
+                           stat.minflt, stat.cminflt, stat.majflt, stat.cmajflt, stat.utime, stat.stime, stat.cutime,
+                           stat.cstime, stat.priority, stat.nice, stat.num_threads, stat.itrealvalue, stat.starttime,
+                           stat.vsize, stat.rss);
+}
+
+} // namespace backend::process
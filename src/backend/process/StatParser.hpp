@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+
+#include "Types.hpp"
+
+namespace backend::process {
+
+// Fields of /proc/<pid>/stat, see proc(5). `comm` points into the parsed buffer and includes the parentheses.
+struct ProcessStat {
+  PidType pid;
+  std::string_view comm;
+  char state;
+  PidType ppid;
+  int pgrp;
+  int session;
+  int tty_nr;
+  int tpgid;
+  unsigned int flags;
+  unsigned long minflt;
+  unsigned long cminflt;
+  unsigned long majflt;
+  unsigned long cmajflt;
+  unsigned long utime;
+  unsigned long stime;
+  long cutime;
+  long cstime;
+  long priority;
+  long nice;
+  long num_threads;
+  long itrealvalue;
+  unsigned long long starttime;
+  unsigned long vsize;
+  long rss;
+};
+
+class StatParser {
+public:
+  // A stat line is a few hundred bytes; comm is at most 64 bytes even for kernel threads.
+  using Buffer = std::array<char, 1024>;
+
+  static bool Parse(std::string_view content, ProcessStat& stat);
+};
+
+} // namespace backend::process
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+
+#include "../metrics/DateType.hpp"
+#include "Types.hpp"
+
+namespace backend::process {
+
+// Whole process values collected in bulk rather than from /proc/<pid>, in the units of /proc/<pid>/stat and io.
+struct TaskSample {
+  PidType pid = 0;
+  PidType ppid = 0;
+  char state = 0;
+  std::array<char, 16> comm{};
+  unsigned long utime = 0;
+  unsigned long stime = 0;
+  unsigned long long starttime = 0;
+  long rss = 0;
+  unsigned long minflt = 0;
+  unsigned long cminflt = 0;
+  unsigned long majflt = 0;
+  unsigned long cmajflt = 0;
+  long priority = 0;
+  long nice = 0;
+  long num_threads = 0;
+  unsigned long vsize = 0;
+  int pgrp = 0;
+  int session = 0;
+  int tty_nr = 0;
+  int tpgid = -1;
+  unsigned int flags = 0;
+  long cutime = 0;
+  long cstime = 0;
+  // Always 0 since Linux 2.6.17, in /proc/<pid>/stat as well.
+  long itrealvalue = 0;
+
+  metrics::DataType rchar = 0;
+  metrics::DataType wchar = 0;
+  metrics::DataType syscr = 0;
+  metrics::DataType syscw = 0;
+  metrics::DataType read_bytes = 0;
+  metrics::DataType write_bytes = 0;
+  metrics::DataType cancelled_write_bytes = 0;
+};
+
+} // namespace backend::process
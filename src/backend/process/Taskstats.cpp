@@ -0,0 +1,278 @@
+#include "Taskstats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <linux/genetlink.h>
+#include <linux/netlink.h>
+#include <linux/taskstats.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace backend::process {
+
+namespace {
+
+// Appends a generic netlink request carrying a single attribute to `buffer`.
+void AppendRequest(std::vector<char>& buffer, uint16_t family, uint8_t command, uint16_t type, const void* value,
+                   size_t length, uint32_t sequence) {
+  size_t payload = GENL_HDRLEN + NLA_HDRLEN + length;
+  size_t offset = buffer.size();
+  buffer.resize(offset + NLMSG_SPACE(payload));
+
+  auto header = reinterpret_cast<struct nlmsghdr*>(buffer.data() + offset);
+  header->nlmsg_len = NLMSG_LENGTH(payload);
+  header->nlmsg_type = family;
+  header->nlmsg_flags = NLM_F_REQUEST;
+  header->nlmsg_seq = sequence;
+
+  auto genl = static_cast<struct genlmsghdr*>(NLMSG_DATA(header));
+  genl->cmd = command;
+  genl->version = TASKSTATS_GENL_VERSION;
+
+  auto attribute = reinterpret_cast<struct nlattr*>(reinterpret_cast<char*>(genl) + GENL_HDRLEN);
+  attribute->nla_type = type;
+  attribute->nla_len = NLA_HDRLEN + length;
+  std::memcpy(reinterpret_cast<char*>(attribute) + NLA_HDRLEN, value, length);
+}
+
+template <typename Callback> void ForEachAttribute(const char* data, size_t size, Callback&& callback) {
+  while (size >= NLA_HDRLEN) {
+    auto attribute = reinterpret_cast<const struct nlattr*>(data);
+    if (attribute->nla_len < NLA_HDRLEN || attribute->nla_len > size) {
+      return;
+    }
+    callback(attribute->nla_type & NLA_TYPE_MASK, data + NLA_HDRLEN, attribute->nla_len - NLA_HDRLEN);
+
+    size_t aligned = NLA_ALIGN(attribute->nla_len);
+    if (aligned >= size) {
+      return;
+    }
+    data += aligned;
+    size -= aligned;
+  }
+}
+
+// Calls `callback` with the payload of each message in `data`. Returns the number of messages, error replies
+// included.
+template <typename Callback> size_t ForEachMessage(const char* data, size_t size, Callback&& callback) {
+  size_t count = 0;
+  int remaining = size;
+  for (auto header = reinterpret_cast<const struct nlmsghdr*>(data); NLMSG_OK(header, remaining);
+       header = NLMSG_NEXT(header, remaining)) {
+    ++count;
+    if (header->nlmsg_type == NLMSG_ERROR || header->nlmsg_type == NLMSG_NOOP || header->nlmsg_type == NLMSG_DONE) {
+      continue;
+    }
+    if (header->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) {
+      continue;
+    }
+    callback(static_cast<const char*>(NLMSG_DATA(header)) + GENL_HDRLEN,
+             header->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN));
+  }
+  return count;
+}
+
+// Waits up to `timeout` for `fd` to be readable. Returns false on timeout.
+bool WaitReadable(int fd, std::chrono::steady_clock::duration timeout) {
+  struct pollfd pfd = {.fd = fd, .events = POLLIN, .revents = 0};
+  auto milliseconds = std::chrono::ceil<std::chrono::milliseconds>(timeout).count();
+  int ready = poll(&pfd, 1, static_cast<int>(std::max<decltype(milliseconds)>(milliseconds, 0)));
+  if (ready < 0 && errno != EINTR) {
+    throw std::system_error(errno, std::generic_category());
+  }
+  return ready > 0;
+}
+
+// The kernel's struct taskstats may be shorter or longer than ours.
+struct taskstats ReadStats(const char* data, size_t size) {
+  struct taskstats stats = {};
+  std::memcpy(&stats, data, std::min(size, sizeof(stats)));
+  return stats;
+}
+
+} // namespace
+
+Taskstats::Taskstats() : _FamilyId(ResolveFamily(utils::FileHandle(OpenSocket()))) {}
+
+int Taskstats::OpenSocket() {
+  return PosixE(socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_GENERIC));
+}
+
+uint16_t Taskstats::ResolveFamily(int fd) {
+  std::vector<char> request;
+  AppendRequest(request, GENL_ID_CTRL, CTRL_CMD_GETFAMILY, CTRL_ATTR_FAMILY_NAME, TASKSTATS_GENL_NAME,
+                sizeof(TASKSTATS_GENL_NAME), 0);
+  PosixE(send(fd, request.data(), request.size(), 0));
+
+  // Only once, at startup.
+  if (!WaitReadable(fd, std::chrono::seconds(1))) {
+    throw std::system_error(ETIMEDOUT, std::generic_category());
+  }
+  alignas(struct nlmsghdr) std::array<char, 4096> buffer;
+  ssize_t bytes = PosixE(recv(fd, buffer.data(), buffer.size(), 0));
+
+  auto header = reinterpret_cast<const struct nlmsghdr*>(buffer.data());
+  if (!NLMSG_OK(header, bytes)) {
+    throw std::system_error(EPROTO, std::generic_category());
+  } else if (header->nlmsg_type == NLMSG_ERROR) {
+    auto error = static_cast<const struct nlmsgerr*>(NLMSG_DATA(header));
+    throw std::system_error(-error->error, std::generic_category());
+  }
+
+  uint16_t family = 0;
+  ForEachMessage(buffer.data(), bytes, [&](const char* data, size_t size) {
+    ForEachAttribute(data, size, [&](uint16_t type, const char* value, size_t length) {
+      if (type == CTRL_ATTR_FAMILY_ID && length >= sizeof(family)) {
+        std::memcpy(&family, value, sizeof(family));
+      }
+    });
+  });
+  if (family == 0) {
+    throw std::system_error(ENOENT, std::generic_category());
+  }
+  return family;
+}
+
+int Taskstats::OpenQuerySocket() const {
+  int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_GENERIC);
+  if (fd >= 0) {
+    // Replies of a whole batch queue up before we read them.
+    int bufferSize = 1 << 20;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+  }
+  return fd;
+}
+
+void Taskstats::Query(int fd, std::span<const PidType> tgids) {
+  for (auto tgid : tgids) {
+    if (_Queued.insert(tgid).second) {
+      _Unsent.push_back(tgid);
+    }
+  }
+
+  // A whole refresh is far longer than the kernel takes to answer, the missing replies were dropped.
+  _Outstanding = 0;
+  SendBatch(fd);
+}
+
+void Taskstats::SendBatch(int fd) {
+  size_t size = std::min(BatchSize, _Unsent.size());
+  if (size == 0) {
+    return;
+  }
+
+  std::vector<char> request;
+  for (size_t i = 0; i < size; ++i) {
+    uint32_t tgid = _Unsent.front();
+    _Unsent.pop_front();
+    _Queued.erase(tgid);
+    AppendRequest(request, _FamilyId, TASKSTATS_CMD_GET, TASKSTATS_CMD_ATTR_TGID, &tgid, sizeof(tgid), ++_Sequence);
+  }
+  PosixE(send(fd, request.data(), request.size(), 0));
+  _Outstanding = size;
+}
+
+void Taskstats::ReceiveReplies(int fd, std::vector<TaskAccounting>& result) {
+  alignas(struct nlmsghdr) std::array<char, 65536> buffer;
+  while (true) {
+    ssize_t bytes = recv(fd, buffer.data(), buffer.size(), 0);
+    if (bytes >= 0) {
+      // Each request is answered by exactly one message, either the statistics or an error such as ESRCH.
+      size_t count =
+          ForEachMessage(buffer.data(), bytes, [&](const char* data, size_t size) { ParseReply(data, size, result); });
+      size_t answered = std::min(count, _Outstanding);
+      _Outstanding -= answered;
+      if (answered > 0 && _Outstanding == 0) {
+        SendBatch(fd);
+      }
+    } else if (errno == ENOBUFS) {
+      // Replies were dropped. Their processes are queried again on the next refresh, which also resumes the queue.
+      _Outstanding = 0;
+    } else if (errno != EINTR) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return;
+      }
+      throw std::system_error(errno, std::generic_category());
+    }
+  }
+}
+
+int Taskstats::OpenExitListener() const {
+  int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_GENERIC);
+  if (fd < 0) {
+    return -1;
+  }
+
+  std::string cpumask = "0-" + std::to_string(sysconf(_SC_NPROCESSORS_CONF) - 1);
+  std::vector<char> request;
+  AppendRequest(request, _FamilyId, TASKSTATS_CMD_GET, TASKSTATS_CMD_ATTR_REGISTER_CPUMASK, cpumask.c_str(),
+                cpumask.size() + 1, 0);
+  if (send(fd, request.data(), request.size(), 0) < 0) {
+    int err = errno;
+    close(fd);
+    errno = err;
+    return -1;
+  }
+  return fd;
+}
+
+void Taskstats::ReceiveExits(int fd, std::vector<TaskAccounting>& result) const {
+  alignas(struct nlmsghdr) std::array<char, 65536> buffer;
+  while (true) {
+    ssize_t bytes = recv(fd, buffer.data(), buffer.size(), 0);
+    if (bytes < 0) {
+      if (errno == ENOBUFS || errno == EINTR) {
+        // Lost exit records only cost precision, the processes themselves are still noticed to be gone.
+        continue;
+      } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return;
+      }
+      throw std::system_error(errno, std::generic_category());
+    }
+    ForEachMessage(buffer.data(), bytes, [&](const char* data, size_t size) { ParseReply(data, size, result); });
+  }
+}
+
+void Taskstats::ParseReply(const void* data, size_t size, std::vector<TaskAccounting>& result) {
+  TaskAccounting accounting;
+
+  ForEachAttribute(static_cast<const char*>(data), size, [&](uint16_t type, const char* value, size_t length) {
+    if (type != TASKSTATS_TYPE_AGGR_TGID && type != TASKSTATS_TYPE_AGGR_PID) {
+      return;
+    }
+
+    uint32_t id = 0;
+    ForEachAttribute(value, length, [&](uint16_t nestedType, const char* nestedValue, size_t nestedLength) {
+      if ((nestedType == TASKSTATS_TYPE_PID || nestedType == TASKSTATS_TYPE_TGID) && nestedLength >= sizeof(id)) {
+        std::memcpy(&id, nestedValue, sizeof(id));
+        return;
+      } else if (nestedType != TASKSTATS_TYPE_STATS || id == 0) {
+        return;
+      }
+
+      auto stats = ReadStats(nestedValue, nestedLength);
+      if (type == TASKSTATS_TYPE_AGGR_TGID) {
+        // Live query of a thread group, or the last thread of a group has exited.
+        accounting.tgid = id;
+        accounting.delays =
+            TaskAccounting::Delays{stats.cpu_delay_total, stats.blkio_delay_total, stats.swapin_delay_total};
+      } else if (stats.ac_tgid == id) {
+        // A single thread exited, only the group leader stands for the process.
+        accounting.tgid = id;
+        accounting.io = TaskAccounting::Io{stats.read_char,      stats.write_char, stats.read_syscalls,
+                                           stats.write_syscalls, stats.read_bytes, stats.write_bytes,
+                                           stats.cancelled_write_bytes};
+      }
+    });
+  });
+
+  if (accounting.tgid != 0) {
+    result.push_back(accounting);
+  }
+}
+
+} // namespace backend::process
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <deque>
+#include <optional>
+#include <span>
+#include <stdint.h>
+#include <unordered_set>
+#include <vector>
+
+#include "../../utils/Error.hpp"
+#include "../metrics/DateType.hpp"
+#include "Types.hpp"
+
+namespace backend::process {
+
+// Accounting of one thread group from taskstats.
+struct TaskAccounting {
+  PidType tgid = 0;
+
+  // Totals in nanoseconds. Reported for live thread groups, and once more when the whole group has exited.
+  struct Delays {
+    metrics::DataType run;
+    metrics::DataType blkio;
+    metrics::DataType swapin;
+  };
+  std::optional<Delays> delays;
+
+  // Only reported when the group leader exits: the kernel does not aggregate io per thread group, so this covers
+  // the leader thread alone. The byte counters are rounded down to KiB.
+  struct Io {
+    metrics::DataType rchar;
+    metrics::DataType wchar;
+    metrics::DataType syscr;
+    metrics::DataType syscw;
+    metrics::DataType read_bytes;
+    metrics::DataType write_bytes;
+    metrics::DataType cancelled_write_bytes;
+  };
+  std::optional<Io> io;
+};
+
+// Client of the TASKSTATS generic netlink family. Needs CAP_NET_ADMIN, delays are only accounted when the kernel
+// runs with delayacct (sysctl kernel.task_delayacct).
+class Taskstats {
+public:
+  // Throws std::system_error when the family cannot be resolved.
+  explicit Taskstats();
+  ~Taskstats() = default;
+
+  Taskstats(const Taskstats&) = delete;
+  Taskstats(Taskstats&&) = delete;
+  Taskstats& operator=(const Taskstats&) = delete;
+  Taskstats& operator=(Taskstats&&) = delete;
+
+  // Returns a non-blocking socket for Query and ReceiveReplies, or -1 with errno set.
+  int OpenQuerySocket() const;
+  // Queues the tgids not queued yet and sends the first batch unless one is still being answered. Never waits:
+  // the replies are read by ReceiveReplies once `fd` is readable, which also sends the following batches.
+  void Query(int fd, std::span<const PidType> tgids);
+  // Drains `fd` as returned by OpenQuerySocket. Thread groups which are gone are left out of `result`.
+  void ReceiveReplies(int fd, std::vector<TaskAccounting>& result);
+
+  // Returns a non-blocking socket which receives the final accounting of every exiting thread group, or -1 with
+  // errno set.
+  int OpenExitListener() const;
+  // Drains `fd` as returned by OpenExitListener.
+  void ReceiveExits(int fd, std::vector<TaskAccounting>& result) const;
+
+private:
+  static constexpr size_t BatchSize = 256;
+
+  static int OpenSocket();
+  static uint16_t ResolveFamily(int fd);
+  static void ParseReply(const void* data, size_t size, std::vector<TaskAccounting>& result);
+  void SendBatch(int fd);
+
+  const uint16_t _FamilyId;
+  uint32_t _Sequence = 0;
+  // The tgids not sent yet, oldest first, so none starves when the table is larger than a refresh can cover.
+  std::deque<PidType> _Unsent;
+  std::unordered_set<PidType> _Queued;
+  // Requests of the last batch still waiting for their reply.
+  size_t _Outstanding = 0;
+};
+
+} // namespace backend::process
@@ -0,0 +1,151 @@
+#include "UringReader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+namespace backend::process {
+
+int UringReader::Setup(unsigned entries, struct io_uring_params& params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+}
+
+UringReader::UringReader(unsigned entries) : _Ring(PosixE(Setup(entries, _Params))) {
+  Probe();
+
+  _SqMapSize = _Params.sq_off.array + _Params.sq_entries * sizeof(unsigned);
+  _CqMapSize = _Params.cq_off.cqes + _Params.cq_entries * sizeof(struct io_uring_cqe);
+  if (_Params.features & IORING_FEAT_SINGLE_MMAP) {
+    _SqMapSize = _CqMapSize = std::max(_SqMapSize, _CqMapSize);
+  }
+  _SqesSize = _Params.sq_entries * sizeof(struct io_uring_sqe);
+
+  auto map = [this](size_t size, off_t offset) {
+    void* result = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _Ring, offset);
+    if (result == MAP_FAILED) {
+      int err = errno;
+      Unmap();
+      throw std::system_error(err, std::generic_category());
+    }
+    return result;
+  };
+
+  _SqMap = map(_SqMapSize, IORING_OFF_SQ_RING);
+  if (_Params.features & IORING_FEAT_SINGLE_MMAP) {
+    _CqMap = _SqMap;
+  } else {
+    _CqMap = map(_CqMapSize, IORING_OFF_CQ_RING);
+  }
+  _Sqes = static_cast<io_uring_sqe*>(map(_SqesSize, IORING_OFF_SQES));
+
+  auto* sq = static_cast<char*>(_SqMap);
+  _SqHead = reinterpret_cast<unsigned*>(sq + _Params.sq_off.head);
+  _SqTail = reinterpret_cast<unsigned*>(sq + _Params.sq_off.tail);
+  _SqMask = *reinterpret_cast<unsigned*>(sq + _Params.sq_off.ring_mask);
+  _SqArray = reinterpret_cast<unsigned*>(sq + _Params.sq_off.array);
+
+  auto* cq = static_cast<char*>(_CqMap);
+  _CqHead = reinterpret_cast<unsigned*>(cq + _Params.cq_off.head);
+  _CqTail = reinterpret_cast<unsigned*>(cq + _Params.cq_off.tail);
+  _CqMask = *reinterpret_cast<unsigned*>(cq + _Params.cq_off.ring_mask);
+  _Cqes = reinterpret_cast<io_uring_cqe*>(cq + _Params.cq_off.cqes);
+}
+
+UringReader::~UringReader() { Unmap(); }
+
+void UringReader::Unmap() {
+  if (_Sqes) {
+    munmap(_Sqes, _SqesSize);
+    _Sqes = nullptr;
+  }
+  if (_CqMap && _CqMap != _SqMap) {
+    munmap(_CqMap, _CqMapSize);
+  }
+  _CqMap = nullptr;
+  if (_SqMap) {
+    munmap(_SqMap, _SqMapSize);
+    _SqMap = nullptr;
+  }
+}
+
+void UringReader::Probe() {
+  // IORING_OP_READ and the probe itself both came with Linux 5.6, older rings fail the registration.
+  constexpr unsigned ops = 256;
+  std::vector<char> buffer(sizeof(struct io_uring_probe) + ops * sizeof(struct io_uring_probe_op));
+  auto* probe = reinterpret_cast<struct io_uring_probe*>(buffer.data());
+  PosixE(static_cast<int>(syscall(__NR_io_uring_register, static_cast<int>(_Ring), IORING_REGISTER_PROBE, probe, ops)));
+  if (probe->last_op < IORING_OP_READ || !(probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED)) {
+    throw std::system_error(EOPNOTSUPP, std::generic_category());
+  }
+}
+
+void UringReader::Read(std::span<BatchRead> reads) {
+  size_t next = 0;
+  unsigned unsubmitted = 0;
+  unsigned inflight = 0;
+
+  while (next < reads.size() || unsubmitted > 0 || inflight > 0) {
+    // Never queue more than the submission ring holds; the completion ring is twice as large, so it can't overflow.
+    unsigned tail = *_SqTail;
+    while (next < reads.size() && inflight + unsubmitted < _Params.sq_entries) {
+      auto& read = reads[next];
+      if (read.Fd < 0) {
+        ++next;
+        continue;
+      }
+
+      unsigned index = tail & _SqMask;
+      auto& sqe = _Sqes[index];
+      memset(&sqe, 0, sizeof(sqe));
+      sqe.opcode = IORING_OP_READ;
+      sqe.fd = read.Fd;
+      sqe.addr = reinterpret_cast<uintptr_t>(read.Buffer.data());
+      sqe.len = static_cast<unsigned>(read.Buffer.size());
+      sqe.off = 0;
+      sqe.user_data = next;
+      _SqArray[index] = index;
+
+      ++tail;
+      ++next;
+      ++unsubmitted;
+    }
+    std::atomic_ref(*_SqTail).store(tail, std::memory_order_release);
+
+    if (unsubmitted == 0 && inflight == 0) {
+      break;
+    }
+
+    int submitted = static_cast<int>(
+        syscall(__NR_io_uring_enter, static_cast<int>(_Ring), unsubmitted, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+    if (submitted < 0) {
+      // EAGAIN and EBUSY mean the kernel is short on resources until completions are reaped.
+      if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        throw std::system_error(errno, std::generic_category());
+      }
+      submitted = 0;
+    }
+    unsubmitted -= submitted;
+    inflight += submitted;
+
+    inflight -= Reap(reads);
+  }
+}
+
+size_t UringReader::Reap(std::span<BatchRead> reads) {
+  unsigned head = *_CqHead;
+  unsigned tail = std::atomic_ref(*_CqTail).load(std::memory_order_acquire);
+
+  size_t count = 0;
+  for (; head != tail; ++head, ++count) {
+    auto& cqe = _Cqes[head & _CqMask];
+    reads[cqe.user_data].Result = cqe.res;
+  }
+  std::atomic_ref(*_CqHead).store(head, std::memory_order_release);
+  return count;
+}
+
+} // namespace backend::process
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <linux/io_uring.h>
+#include <span>
+#include <stddef.h>
+
+#include "../../utils/Error.hpp"
+
+namespace backend::process {
+
+// One read of a whole file from offset 0, as pread would do it.
+struct BatchRead {
+  // Reads with a negative descriptor are skipped.
+  int Fd = -1;
+  std::span<char> Buffer;
+  // Bytes read, or -errno.
+  int Result = 0;
+};
+
+// Reads many files with few syscalls through an io_uring. procfs has no async read path, so the kernel hands these
+// reads to its io worker threads; what is saved is the per-file syscall and the waiting is done in parallel.
+class UringReader {
+public:
+  // Throws std::system_error when io_uring is not available: kernel too old, disabled by
+  // sysctl kernel.io_uring_disabled or by seccomp, or lacking IORING_OP_READ.
+  explicit UringReader(unsigned entries = 256);
+  ~UringReader();
+
+  UringReader(const UringReader&) = delete;
+  UringReader(UringReader&&) = delete;
+  UringReader& operator=(const UringReader&) = delete;
+  UringReader& operator=(UringReader&&) = delete;
+
+  // Submits all reads and returns when every one of them has completed.
+  void Read(std::span<BatchRead> reads);
+
+private:
+  static int Setup(unsigned entries, struct io_uring_params& params);
+  void Probe();
+  void Unmap();
+  size_t Reap(std::span<BatchRead> reads);
+
+  struct io_uring_params _Params {};
+  utils::FileHandle _Ring;
+
+  void* _SqMap = nullptr;
+  size_t _SqMapSize = 0;
+  void* _CqMap = nullptr;
+  size_t _CqMapSize = 0;
+  io_uring_sqe* _Sqes = nullptr;
+  size_t _SqesSize = 0;
+
+  unsigned* _SqHead;
+  unsigned* _SqTail;
+  unsigned _SqMask;
+  unsigned* _SqArray;
+  unsigned* _CqHead;
+  unsigned* _CqTail;
+  unsigned _CqMask;
+  io_uring_cqe* _Cqes;
+};
+
+} // namespace backend::process
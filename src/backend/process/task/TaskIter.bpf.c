@@ -0,0 +1,187 @@
+#include <vmlinux.btf.h>
+
+#include <bpf/bpf_core_read.h>
+#include <bpf/bpf_helpers.h>
+#include <bpf/bpf_tracing.h>
+
+#include "TaskIter.bpf.h"
+
+/* Kernel layouts that changed over time, resolved with CO-RE at load time. */
+
+struct task_struct___new {
+  unsigned int __state;
+} __attribute__((preserve_access_index));
+
+struct task_struct___old {
+  long state;
+} __attribute__((preserve_access_index));
+
+struct task_struct___start {
+  u64 start_boottime;
+  u64 real_start_time;
+} __attribute__((preserve_access_index));
+
+/* Before 6.2 the rss counters were atomics, since then they are percpu counters. */
+struct mm_rss_stat___old {
+  atomic_long_t count[4];
+} __attribute__((preserve_access_index));
+
+struct mm_struct___old {
+  struct mm_rss_stat___old rss_stat;
+} __attribute__((preserve_access_index));
+
+struct percpu_counter___new {
+  s64 count;
+} __attribute__((preserve_access_index));
+
+struct mm_struct___new {
+  struct percpu_counter___new rss_stat[4];
+} __attribute__((preserve_access_index));
+
+/* Since 5.19 the foreground process group of a tty lives in its ctrl. */
+struct tty_struct___ctrl {
+  struct {
+    struct pid* pgrp;
+  } ctrl;
+} __attribute__((preserve_access_index));
+
+struct tty_struct___old {
+  struct pid* pgrp;
+} __attribute__((preserve_access_index));
+
+/* MM_FILEPAGES, MM_ANONPAGES and MM_SHMEMPAGES, MM_SWAPENTS (2) is not resident. */
+#define RSS_FILE 0
+#define RSS_ANON 1
+#define RSS_SHMEM 3
+
+static __u32 get_state(struct task_struct* task) {
+  if (bpf_core_field_exists(((struct task_struct___new*)task)->__state)) {
+    return BPF_CORE_READ((struct task_struct___new*)task, __state);
+  }
+  return BPF_CORE_READ((struct task_struct___old*)task, state);
+}
+
+static __u64 get_start_time(struct task_struct* task) {
+  if (bpf_core_field_exists(((struct task_struct___start*)task)->start_boottime)) {
+    return BPF_CORE_READ((struct task_struct___start*)task, start_boottime);
+  }
+  return BPF_CORE_READ((struct task_struct___start*)task, real_start_time);
+}
+
+static __s64 get_rss(struct mm_struct* mm) {
+  __s64 rss;
+
+  if (!mm) {
+    return 0;
+  }
+
+  if (bpf_core_type_exists(struct mm_rss_stat___old)) {
+    struct mm_struct___old* old = (void*)mm;
+    rss = BPF_CORE_READ(old, rss_stat.count[RSS_FILE].counter) + BPF_CORE_READ(old, rss_stat.count[RSS_ANON].counter) +
+          BPF_CORE_READ(old, rss_stat.count[RSS_SHMEM].counter);
+  } else {
+    struct mm_struct___new* new = (void*)mm;
+    rss = BPF_CORE_READ(new, rss_stat[RSS_FILE].count) + BPF_CORE_READ(new, rss_stat[RSS_ANON].count) +
+          BPF_CORE_READ(new, rss_stat[RSS_SHMEM].count);
+  }
+  return rss < 0 ? 0 : rss;
+}
+
+static __u32 get_pid_nr(struct pid* pid) {
+  if (!pid) {
+    return 0;
+  }
+  return BPF_CORE_READ(pid, numbers[0].nr);
+}
+
+/* new_encode_dev() of the tty's device number, as tty_nr in /proc/<pid>/stat. */
+static __u32 get_tty_nr(struct tty_struct* tty) {
+  __u32 major;
+  __u32 minor;
+
+  if (!tty) {
+    return 0;
+  }
+  major = BPF_CORE_READ(tty, driver, major);
+  minor = BPF_CORE_READ(tty, driver, minor_start) + BPF_CORE_READ(tty, index);
+  return (minor & 0xff) | (major << 8) | ((minor & ~0xff) << 12);
+}
+
+static __s32 get_tpgid(struct tty_struct* tty) {
+  struct pid* pgrp;
+
+  if (!tty) {
+    return -1;
+  }
+  if (bpf_core_field_exists(((struct tty_struct___ctrl*)tty)->ctrl)) {
+    pgrp = BPF_CORE_READ((struct tty_struct___ctrl*)tty, ctrl.pgrp);
+  } else {
+    pgrp = BPF_CORE_READ((struct tty_struct___old*)tty, pgrp);
+  }
+  return pgrp ? (__s32)get_pid_nr(pgrp) : -1;
+}
+
+SEC("iter/task")
+int dump_task(struct bpf_iter__task* ctx) {
+  struct seq_file* seq = ctx->meta->seq;
+  struct task_struct* task = ctx->task;
+  struct task_record record = {};
+
+  if (!task) {
+    return 0;
+  }
+
+  record.tgid = BPF_CORE_READ(task, tgid);
+  record.pid = BPF_CORE_READ(task, pid);
+  record.ppid = BPF_CORE_READ(task, real_parent, tgid);
+  record.state = get_state(task);
+  record.exit_state = BPF_CORE_READ(task, exit_state);
+  record.utime = BPF_CORE_READ(task, utime);
+  record.stime = BPF_CORE_READ(task, stime);
+  record.rchar = BPF_CORE_READ(task, ioac.rchar);
+  record.wchar = BPF_CORE_READ(task, ioac.wchar);
+  record.syscr = BPF_CORE_READ(task, ioac.syscr);
+  record.syscw = BPF_CORE_READ(task, ioac.syscw);
+  record.read_bytes = BPF_CORE_READ(task, ioac.read_bytes);
+  record.write_bytes = BPF_CORE_READ(task, ioac.write_bytes);
+  record.cancelled_write_bytes = BPF_CORE_READ(task, ioac.cancelled_write_bytes);
+  record.min_flt = BPF_CORE_READ(task, min_flt);
+  record.maj_flt = BPF_CORE_READ(task, maj_flt);
+
+  if (record.pid == record.tgid) {
+    /* Process wide values live in the leader's record only. */
+    record.start_time = get_start_time(task);
+    record.rss = get_rss(BPF_CORE_READ(task, mm));
+    record.total_vm = BPF_CORE_READ(task, mm, total_vm);
+    record.prio = BPF_CORE_READ(task, prio);
+    record.static_prio = BPF_CORE_READ(task, static_prio);
+    record.nr_threads = BPF_CORE_READ(task, signal, nr_threads);
+    record.flags = BPF_CORE_READ(task, flags);
+    record.pgrp = get_pid_nr(BPF_CORE_READ(task, signal, pids[PIDTYPE_PGID]));
+    record.session = get_pid_nr(BPF_CORE_READ(task, signal, pids[PIDTYPE_SID]));
+    record.tty_nr = get_tty_nr(BPF_CORE_READ(task, signal, tty));
+    record.tpgid = get_tpgid(BPF_CORE_READ(task, signal, tty));
+    record.cutime = BPF_CORE_READ(task, signal, cutime);
+    record.cstime = BPF_CORE_READ(task, signal, cstime);
+    BPF_CORE_READ_STR_INTO(&record.comm, task, comm);
+
+    record.utime += BPF_CORE_READ(task, signal, utime);
+    record.stime += BPF_CORE_READ(task, signal, stime);
+    record.rchar += BPF_CORE_READ(task, signal, ioac.rchar);
+    record.wchar += BPF_CORE_READ(task, signal, ioac.wchar);
+    record.syscr += BPF_CORE_READ(task, signal, ioac.syscr);
+    record.syscw += BPF_CORE_READ(task, signal, ioac.syscw);
+    record.read_bytes += BPF_CORE_READ(task, signal, ioac.read_bytes);
+    record.write_bytes += BPF_CORE_READ(task, signal, ioac.write_bytes);
+    record.cancelled_write_bytes += BPF_CORE_READ(task, signal, ioac.cancelled_write_bytes);
+    record.min_flt += BPF_CORE_READ(task, signal, min_flt);
+    record.maj_flt += BPF_CORE_READ(task, signal, maj_flt);
+    record.cmin_flt = BPF_CORE_READ(task, signal, cmin_flt);
+    record.cmaj_flt = BPF_CORE_READ(task, signal, cmaj_flt);
+  }
+
+  bpf_seq_write(seq, &record, sizeof(record));
+  return 0;
+}
+
+char LICENSE[] SEC("license") = "Dual BSD/GPL";
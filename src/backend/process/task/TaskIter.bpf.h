@@ -0,0 +1,43 @@
+#pragma once
+
+#define TASK_COMM_LEN 16
+
+/* One record per task. Times are in nanoseconds, rss and total_vm in pages, the io counters are bytes or syscalls. A
+ * thread group leader also carries what its dead threads left in signal_struct, so summing all records of a tgid gives
+ * the same totals as /proc/<pid>/stat and /proc/<pid>/io. prio and static_prio are the raw kernel values. pgrp, session
+ * and tpgid are in the initial pid namespace, tty_nr is encoded as in /proc/<pid>/stat. */
+struct task_record {
+  __u32 tgid;
+  __u32 pid;
+  __u32 ppid;
+  __u32 state;
+  __u32 exit_state;
+  __u32 padding;
+  __u64 utime;
+  __u64 stime;
+  __u64 start_time;
+  __u64 rss;
+  __u64 rchar;
+  __u64 wchar;
+  __u64 syscr;
+  __u64 syscw;
+  __u64 read_bytes;
+  __u64 write_bytes;
+  __u64 cancelled_write_bytes;
+  __u64 min_flt;
+  __u64 maj_flt;
+  __u64 cmin_flt;
+  __u64 cmaj_flt;
+  __u64 total_vm;
+  __s32 prio;
+  __s32 static_prio;
+  __u32 nr_threads;
+  __u32 flags;
+  __u32 pgrp;
+  __u32 session;
+  __u32 tty_nr;
+  __s32 tpgid;
+  __u64 cutime;
+  __u64 cstime;
+  char comm[TASK_COMM_LEN];
+};
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <bit>
+#include <bpf/bpf.h>
+#include <bpf/libbpf.h>
+#include <cstring>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "../../../utils/Error.hpp"
+#include "TaskIter.bpf.h"
+#include "TaskIter.hpp"
+#include "TaskIter.skel.h"
+
+namespace backend::process::task {
+
+TaskIter::TaskIter(bpf::BpfManager& manager) {
+  LIBBPF_OPTS(bpf_object_open_opts, open_opts);
+  _BpfObj = TaskIter_bpf__open_opts(&open_opts);
+  if (!_BpfObj) {
+    throw std::runtime_error("failed to open BPF object");
+  }
+
+  int err = TaskIter_bpf__load(_BpfObj);
+  if (err) {
+    TaskIter_bpf__destroy(_BpfObj);
+    throw std::runtime_error(std::format("failed to load BPF object: {}", err));
+  }
+
+  _Link = bpf_program__attach_iter(_BpfObj->progs.dump_task, nullptr);
+  if (!_Link) {
+    TaskIter_bpf__destroy(_BpfObj);
+    throw std::runtime_error(std::format("failed to attach BPF task iterator: {}", strerror(errno)));
+  }
+}
+
+TaskIter::~TaskIter() {
+  bpf_link__destroy(_Link);
+  TaskIter_bpf__destroy(_BpfObj);
+}
+
+void TaskIter::Read(std::unordered_map<PidType, TaskSample>& samples) {
+  // Every read of a new iterator instance walks all tasks once.
+  utils::FileHandle fd(PosixE(bpf_iter_create(bpf_link__fd(_Link))));
+
+  size_t bytes = 0;
+  while (true) {
+    if (_Records.size() * sizeof(struct task_record) - bytes < sizeof(struct task_record)) {
+      _Records.resize(std::max<size_t>(_Records.size() * 2, 1024));
+    }
+    auto buffer = reinterpret_cast<char*>(_Records.data());
+    ssize_t n = PosixE(read(fd, buffer + bytes, _Records.size() * sizeof(struct task_record) - bytes));
+    if (n == 0) {
+      break;
+    }
+    bytes += n;
+  }
+
+  static const unsigned long pageSize = sysconf(_SC_PAGESIZE);
+  static const unsigned long long nanosecondsPerJiffy = 1000000000ull / sysconf(_SC_CLK_TCK);
+  samples.clear();
+  for (auto& record : std::span(_Records.data(), bytes / sizeof(struct task_record))) {
+    auto& sample = samples[record.tgid];
+    if (record.pid == record.tgid) {
+      sample.pid = record.tgid;
+      sample.ppid = record.ppid;
+      sample.state = StateChar(record.state, record.exit_state);
+      std::memcpy(sample.comm.data(), record.comm, std::min(sample.comm.size(), sizeof(record.comm)));
+      sample.starttime = record.start_time;
+      sample.rss = record.rss;
+      sample.vsize = record.total_vm * pageSize;
+      sample.cminflt = record.cmin_flt;
+      sample.cmajflt = record.cmaj_flt;
+      // As in /proc/<pid>/stat: prio counted from MAX_RT_PRIO, nice from DEFAULT_PRIO.
+      sample.priority = record.prio - 100;
+      sample.nice = record.static_prio - 120;
+      sample.num_threads = record.nr_threads;
+      sample.pgrp = record.pgrp;
+      sample.session = record.session;
+      sample.tty_nr = record.tty_nr;
+      sample.tpgid = record.tpgid;
+      sample.flags = record.flags;
+      sample.cutime = record.cutime / nanosecondsPerJiffy;
+      sample.cstime = record.cstime / nanosecondsPerJiffy;
+    }
+
+    // Times are summed in nanoseconds and converted below, so rounding doesn't add up over threads.
+    sample.utime += record.utime;
+    sample.stime += record.stime;
+    sample.rchar += record.rchar;
+    sample.wchar += record.wchar;
+    sample.syscr += record.syscr;
+    sample.syscw += record.syscw;
+    sample.read_bytes += record.read_bytes;
+    sample.write_bytes += record.write_bytes;
+    sample.cancelled_write_bytes += record.cancelled_write_bytes;
+    sample.minflt += record.min_flt;
+    sample.majflt += record.maj_flt;
+  }
+
+  std::erase_if(samples, [](auto& entry) { return entry.second.pid == 0; });
+  for (auto& [_, sample] : samples) {
+    sample.utime /= nanosecondsPerJiffy;
+    sample.stime /= nanosecondsPerJiffy;
+    sample.starttime /= nanosecondsPerJiffy;
+  }
+}
+
+char TaskIter::StateChar(__u32 state, __u32 exitState) {
+  // Mirrors task_state_index() of the kernel: TASK_REPORT bits, TASK_IDLE is reported separately.
+  constexpr __u32 taskReport = 0x7f;
+  constexpr __u32 taskIdle = 0x402;
+  constexpr const char* states = "RSDTtXZPI";
+
+  if (state == taskIdle) {
+    return 'I';
+  }
+  return states[std::bit_width((state | exitState) & taskReport)];
+}
+
+} // namespace backend::process::task
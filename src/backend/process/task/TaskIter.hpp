@@ -0,0 +1,37 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "../../bpf/BpfManager.hpp"
+#include "../TaskSample.hpp"
+
+#include "TaskIter.bpf.h"
+
+struct TaskIter_bpf;
+
+namespace backend::process::task {
+
+// Reads the statistics of every task on the system through a single BPF task iterator pass.
+class TaskIter {
+public:
+  explicit TaskIter(bpf::BpfManager& manager);
+  ~TaskIter();
+
+  TaskIter(const TaskIter&) = delete;
+  TaskIter(TaskIter&&) = delete;
+  TaskIter& operator=(const TaskIter&) = delete;
+  TaskIter& operator=(TaskIter&&) = delete;
+
+  // Replaces the content of `samples` with one entry per thread group.
+  void Read(std::unordered_map<PidType, TaskSample>& samples);
+
+private:
+  static char StateChar(__u32 state, __u32 exitState);
+
+  struct TaskIter_bpf* _BpfObj = nullptr;
+  struct bpf_link* _Link = nullptr;
+  std::vector<struct task_record> _Records;
+};
+
+} // namespace backend::process::task
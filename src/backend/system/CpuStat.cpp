@@ -0,0 +1,41 @@
+#include "CpuStat.hpp"
+
+#include "../../utils/FieldParser.hpp"
+
+namespace backend::system {
+
+void CpuStat::Parse(std::string_view text) {
+  auto now = GetUpdateTime();
+  utils::FieldParser parser(text);
+  do {
+    std::string_view key;
+    if (!parser.Next(key)) {
+      break;
+    }
+
+    if (key.starts_with("cpu")) {
+      // "cpu  user nice system idle iowait irq softirq steal guest guest_nice", guest is already part of user.
+      auto& row = GetRow(key.substr(3));
+      metrics::DataType total = 0, idle = 0;
+      for (size_t i = 0; i <= static_cast<size_t>(CpuField::Steal); ++i) {
+        metrics::DataType value = 0;
+        if (!parser.Next(value)) {
+          break;
+        }
+        Set(row, static_cast<CpuField>(i), value);
+        total += value;
+        if (i == static_cast<size_t>(CpuField::Idle) || i == static_cast<size_t>(CpuField::IoWait)) {
+          idle += value;
+        }
+      }
+      Set(row, CpuField::Busy, total - idle);
+      Set(row, CpuField::Total, total);
+    } else if (metrics::DataType value; key == "procs_running" && parser.Next(value)) {
+      _Running->Set(value, now);
+    } else if (key == "procs_blocked" && parser.Next(value)) {
+      _Blocked->Set(value, now);
+    }
+  } while (parser.NextLine());
+}
+
+} // namespace backend::system
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "ProcTable.hpp"
+
+namespace backend::system {
+
+enum class CpuField { User, Nice, System, Idle, IoWait, Irq, SoftIrq, Steal, Busy, Total, Count };
+
+// Per CPU time from /proc/stat, in jiffies. Keys are "0", "1", ...; Total is the "cpu" line over all CPUs. Busy is all
+// time but idle and iowait, so Ratio(CounterSlice(Busy), CounterSlice(Total)) is the utilization.
+class CpuStat : public ProcTable<CpuField> {
+public:
+  explicit CpuStat() : ProcTable("/proc/stat") {}
+  ~CpuStat() override = default;
+
+  // Tasks running and blocked on I/O, from the procs_running and procs_blocked lines.
+  std::shared_ptr<metrics::Gauge> GetRunning() const { return _Running; }
+  std::shared_ptr<metrics::Gauge> GetBlocked() const { return _Blocked; }
+
+private:
+  void Parse(std::string_view text) override;
+
+  std::shared_ptr<SampleGauge> _Running = std::make_shared<SampleGauge>();
+  std::shared_ptr<SampleGauge> _Blocked = std::make_shared<SampleGauge>();
+};
+
+} // namespace backend::system
@@ -0,0 +1,43 @@
+#include "DiskStats.hpp"
+
+#include "../../utils/FieldParser.hpp"
+
+namespace backend::system {
+
+void DiskStats::Parse(std::string_view text) {
+  // Sectors are always 512 bytes here, whatever the device's sector size.
+  constexpr metrics::DataType sector = 512;
+
+  std::array<metrics::DataType, FieldCount> total{};
+  utils::FieldParser parser(text);
+  do {
+    // "   8       0 sda reads merged sectors ms writes merged sectors ms in_flight io_ms weighted_ms ..."
+    std::string_view name;
+    std::array<metrics::DataType, 10> values;
+    if (!parser.Skip(2) || !parser.Next(name) ||
+        !parser.NextAll(values[0], values[1], values[2], values[3], values[4], values[5], values[6], values[7],
+                        values[8], values[9])) {
+      continue;
+    }
+
+    std::array<metrics::DataType, FieldCount> fields{values[0], values[2] * sector, values[4], values[6] * sector,
+                                                     values[8], values[9]};
+    auto& row = GetRow(name);
+    for (size_t i = 0; i < FieldCount; ++i) {
+      Set(row, static_cast<DiskField>(i), fields[i]);
+    }
+
+    if (IsPhysical(name, "/sys/block")) {
+      for (size_t i = 0; i < FieldCount; ++i) {
+        total[i] += fields[i];
+      }
+    }
+  } while (parser.NextLine());
+
+  auto& row = GetRow(Total);
+  for (size_t i = 0; i < FieldCount; ++i) {
+    Set(row, static_cast<DiskField>(i), total[i]);
+  }
+}
+
+} // namespace backend::system
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "ProcTable.hpp"
+
+namespace backend::system {
+
+// Counters, but InFlight. BusyTime is the time with I/O in flight in ms, over the refresh interval it is the
+// utilization.
+enum class DiskField { Reads, ReadBytes, Writes, WriteBytes, InFlight, BusyTime, Count };
+
+// Per block device statistics from /proc/diskstats, keyed by device name. Total sums the physical disks only:
+// partitions, loop and device mapper devices would count the same I/O again.
+class DiskStats : public ProcTable<DiskField> {
+public:
+  explicit DiskStats() : ProcTable("/proc/diskstats") {}
+  ~DiskStats() override = default;
+
+private:
+  void Parse(std::string_view text) override;
+};
+
+} // namespace backend::system
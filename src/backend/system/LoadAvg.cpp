@@ -0,0 +1,22 @@
+#include "LoadAvg.hpp"
+
+#include "../../utils/FieldParser.hpp"
+
+namespace backend::system {
+
+void LoadAvg::Parse(std::string_view text) {
+  // "0.52 0.48 0.40 2/345 12345"
+  auto& row = GetRow(Total);
+  utils::FieldParser parser(text);
+  metrics::DataType load1, load5, load15, runnable, threads;
+  if (parser.NextHundredths(load1) && parser.NextHundredths(load5) && parser.NextHundredths(load15) &&
+      parser.Next(runnable) && parser.SkipPast('/') && parser.Next(threads)) {
+    Set(row, LoadField::Load1, load1);
+    Set(row, LoadField::Load5, load5);
+    Set(row, LoadField::Load15, load15);
+    Set(row, LoadField::Runnable, runnable);
+    Set(row, LoadField::Threads, threads);
+  }
+}
+
+} // namespace backend::system
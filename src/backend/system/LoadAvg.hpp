@@ -0,0 +1,22 @@
+#pragma once
+
+#include "ProcTable.hpp"
+
+namespace backend::system {
+
+// Load averages in hundredths, runnable and total threads. Threads is the number after the slash.
+enum class LoadField { Load1, Load5, Load15, Runnable, Threads, Count };
+
+// /proc/loadavg. It has only the Total row.
+class LoadAvg : public ProcTable<LoadField> {
+public:
+  explicit LoadAvg() : ProcTable("/proc/loadavg") {}
+  ~LoadAvg() override = default;
+
+  std::shared_ptr<metrics::Gauge> GetGauge(LoadField field) { return ProcTable::GetGauge(Total, field); }
+
+private:
+  void Parse(std::string_view text) override;
+};
+
+} // namespace backend::system
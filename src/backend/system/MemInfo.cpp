@@ -0,0 +1,37 @@
+#include "MemInfo.hpp"
+
+#include <algorithm>
+
+#include "../../utils/FieldParser.hpp"
+
+namespace backend::system {
+
+const std::array<MemInfo::Key, MemInfo::FieldCount> MemInfo::_Keys{{
+    {"MemTotal:", MemField::Total},
+    {"MemFree:", MemField::Free},
+    {"MemAvailable:", MemField::Available},
+    {"Buffers:", MemField::Buffers},
+    {"Cached:", MemField::Cached},
+    {"Shmem:", MemField::Shmem},
+    {"SwapTotal:", MemField::SwapTotal},
+    {"SwapFree:", MemField::SwapFree},
+    {"Dirty:", MemField::Dirty},
+}};
+
+void MemInfo::Parse(std::string_view text) {
+  auto& row = GetRow(Total);
+  utils::FieldParser parser(text);
+  do {
+    // "MemTotal:       16314244 kB"
+    std::string_view key;
+    metrics::DataType value;
+    if (!parser.Next(key) || !parser.Next(value)) {
+      continue;
+    }
+    if (auto match = std::ranges::find(_Keys, key, &Key::Name); match != _Keys.end()) {
+      Set(row, match->Target, value * 1024);
+    }
+  } while (parser.NextLine());
+}
+
+} // namespace backend::system
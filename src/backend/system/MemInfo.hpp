@@ -0,0 +1,27 @@
+#pragma once
+
+#include "ProcTable.hpp"
+
+namespace backend::system {
+
+enum class MemField { Total, Free, Available, Buffers, Cached, Shmem, SwapTotal, SwapFree, Dirty, Count };
+
+// /proc/meminfo in bytes. It has only the Total row.
+class MemInfo : public ProcTable<MemField> {
+public:
+  explicit MemInfo() : ProcTable("/proc/meminfo") {}
+  ~MemInfo() override = default;
+
+  std::shared_ptr<metrics::Gauge> GetGauge(MemField field) { return ProcTable::GetGauge(Total, field); }
+
+private:
+  struct Key {
+    std::string_view Name;
+    MemField Target;
+  };
+  static const std::array<Key, FieldCount> _Keys;
+
+  void Parse(std::string_view text) override;
+};
+
+} // namespace backend::system
@@ -0,0 +1,58 @@
+#include "NetDev.hpp"
+
+#include "../../utils/FieldParser.hpp"
+
+namespace backend::system {
+
+void NetDev::Parse(std::string_view text) {
+  std::array<metrics::DataType, FieldCount> physical{}, virtualTotal{};
+  bool anyPhysical = false;
+
+  utils::FieldParser parser(text);
+  // Two header lines.
+  parser.NextLine();
+  while (parser.NextLine()) {
+    // "  eth0: rx_bytes packets errs drop fifo frame compressed multicast tx_bytes packets errs drop fifo colls ..."
+    std::string_view name;
+    if (!parser.Next(name)) {
+      continue;
+    }
+    // Old kernels leave no space between the colon and a long rx_bytes.
+    auto colon = name.find(':');
+    if (colon == std::string_view::npos) {
+      continue;
+    }
+    utils::FieldParser first(name.substr(colon + 1));
+    name = name.substr(0, colon);
+
+    std::array<metrics::DataType, 12> values;
+    if (!(first.Done() ? parser.Next(values[0]) : first.Next(values[0])) ||
+        !parser.NextAll(values[1], values[2], values[3], values[4], values[5], values[6], values[7], values[8],
+                        values[9], values[10], values[11])) {
+      continue;
+    }
+
+    std::array<metrics::DataType, FieldCount> fields{values[0], values[1], values[2],  values[3],
+                                                     values[8], values[9], values[10], values[11]};
+    auto& row = GetRow(name);
+    for (size_t i = 0; i < FieldCount; ++i) {
+      Set(row, static_cast<NetField>(i), fields[i]);
+    }
+
+    bool isPhysical = IsPhysical(name, "/sys/class/net");
+    anyPhysical |= isPhysical;
+    auto& sum = isPhysical ? physical : virtualTotal;
+    if (isPhysical || name != "lo") {
+      for (size_t i = 0; i < FieldCount; ++i) {
+        sum[i] += fields[i];
+      }
+    }
+  }
+
+  auto& row = GetRow(Total);
+  for (size_t i = 0; i < FieldCount; ++i) {
+    Set(row, static_cast<NetField>(i), anyPhysical ? physical[i] : virtualTotal[i]);
+  }
+}
+
+} // namespace backend::system
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "ProcTable.hpp"
+
+namespace backend::system {
+
+enum class NetField { RxBytes, RxPackets, RxErrors, RxDrops, TxBytes, TxPackets, TxErrors, TxDrops, Count };
+
+// Per network interface counters from /proc/net/dev of omnimon's network namespace, keyed by interface name. Total
+// sums the interfaces backed by hardware, or all but loopback when there is none, as inside a container.
+class NetDev : public ProcTable<NetField> {
+public:
+  explicit NetDev() : ProcTable("/proc/net/dev") {}
+  ~NetDev() override = default;
+
+private:
+  void Parse(std::string_view text) override;
+};
+
+} // namespace backend::system
@@ -0,0 +1,100 @@
+#include "Pressure.hpp"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <format>
+#include <string_view>
+#include <unistd.h>
+
+#include "../../utils/FieldParser.hpp"
+
+namespace backend::system {
+
+const std::array<const char*, static_cast<size_t>(Pressure::Resource::Count)> Pressure::_FileNames{"cpu", "memory",
+                                                                                                    "io"};
+
+Pressure::Pressure(Resource resource)
+    : _Resource(resource),
+      _Fd(PosixE(open(std::format("/proc/pressure/{}", _FileNames[static_cast<size_t>(resource)]).c_str(),
+                      O_RDONLY | O_CLOEXEC))) {}
+
+Pressure::Pressure(Resource resource, int fd) : _Resource(resource), _Fd(fd) {}
+
+std::string Pressure::GetCgroupFileName(Resource resource) {
+  return std::format("{}.pressure", _FileNames[static_cast<size_t>(resource)]);
+}
+
+std::shared_ptr<metrics::Gauge> Pressure::GetGauge(std::shared_ptr<Pressure> me, Kind kind, Field field) {
+  auto& gauge = me->_Gauges[static_cast<size_t>(kind) * FieldCount + static_cast<size_t>(field)];
+  if (auto result = gauge.lock()) {
+    return result;
+  } else {
+    result = std::make_shared<PressureGauge>(me, field == Field::Total);
+    gauge = result;
+    me->Update();
+    return result;
+  }
+}
+
+bool Pressure::IsWatched() const {
+  return std::ranges::any_of(_Gauges, [](auto& gauge) { return !gauge.expired(); });
+}
+
+void Pressure::Update() {
+  // "some avg10=0.00 avg60=0.00 avg300=0.00 total=0\nfull avg10=0.00 avg60=0.00 avg300=0.00 total=0\n"
+  std::array<char, 256> buffer;
+  ssize_t size = pread(_Fd, buffer.data(), buffer.size(), 0);
+  if (size <= 0) {
+    return;
+  }
+  _LastUpdate = std::chrono::steady_clock::now();
+
+  static constexpr std::array<std::string_view, FieldCount> keys{"avg10=", "avg60=", "avg300=", "total="};
+  utils::FieldParser parser({buffer.data(), static_cast<size_t>(size)});
+  do {
+    std::string_view word;
+    if (!parser.Next(word)) {
+      break;
+    }
+    size_t kind;
+    if (word == "some") {
+      kind = static_cast<size_t>(Kind::Some);
+    } else if (word == "full") {
+      kind = static_cast<size_t>(Kind::Full);
+    } else {
+      continue;
+    }
+
+    for (size_t field = 0; field < FieldCount && parser.Next(word); ++field) {
+      if (!word.starts_with(keys[field])) {
+        break;
+      }
+      utils::FieldParser number(word.substr(keys[field].size()));
+      metrics::DataType value;
+      bool parsed = static_cast<Field>(field) == Field::Total ? number.Next(value) : number.NextHundredths(value);
+      if (auto gauge = _Gauges[kind * FieldCount + field].lock(); parsed && gauge) {
+        gauge->SetValue(value);
+      }
+    }
+  } while (parser.NextLine());
+}
+
+int Pressure::OpenTrigger(Kind kind, std::chrono::microseconds stall, std::chrono::microseconds window) const {
+  // A trigger needs a descriptor of its own, reopen the same file writable.
+  int fd = open(std::format("/proc/self/fd/{}", static_cast<int>(_Fd)).c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+
+  // The kernel wants the terminating NUL written too.
+  auto trigger = std::format("{} {} {}", kind == Kind::Some ? "some" : "full", stall.count(), window.count());
+  if (write(fd, trigger.c_str(), trigger.size() + 1) < 0) {
+    int err = errno;
+    close(fd);
+    errno = err;
+    return -1;
+  }
+  return fd;
+}
+
+} // namespace backend::system
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "../../utils/Error.hpp"
+#include "../metrics/Gauge.hpp"
+
+namespace backend::system {
+
+// Pressure stall information of one resource, system wide from /proc/pressure or of one cgroup.
+class Pressure {
+public:
+  enum class Resource { Cpu, Memory, Io, Count };
+  // Some: at least one task stalled. Full: all non-idle tasks stalled at once, always 0 for the system wide CPU.
+  enum class Kind { Some, Full, Count };
+  // The averages are percentages in hundredths, the same scale as metrics::Ratio. Total is the stall time in usec.
+  enum class Field { Avg10, Avg60, Avg300, Total, Count };
+
+  // Throws std::system_error when the file can't be opened: a kernel without CONFIG_PSI or booted with psi=0.
+  explicit Pressure(Resource resource);
+  // `fd` is the opened <resource>.pressure of a cgroup v2 directory, this object takes it over.
+  explicit Pressure(Resource resource, int fd);
+  ~Pressure() = default;
+
+  Pressure(const Pressure&) = delete;
+  Pressure(Pressure&&) = delete;
+  Pressure& operator=(const Pressure&) = delete;
+  Pressure& operator=(Pressure&&) = delete;
+
+  static std::shared_ptr<metrics::Gauge> GetGauge(std::shared_ptr<Pressure> me, Kind kind, Field field);
+  // <resource>.pressure, as found in cgroup directories.
+  static std::string GetCgroupFileName(Resource resource);
+
+  Resource GetResource() const { return _Resource; }
+  bool IsWatched() const;
+  void Update();
+
+  // Registers a PSI trigger: the returned descriptor signals POLLPRI as soon as tasks stalled for `stall` within any
+  // `window`. The window must be between 500ms and 10s; unprivileged users are limited to multiples of 2s. Returns -1
+  // with errno set on failure. The caller owns the descriptor, closing it removes the trigger.
+  int OpenTrigger(Kind kind, std::chrono::microseconds stall, std::chrono::microseconds window) const;
+
+private:
+  class PressureGauge : public metrics::Gauge {
+  public:
+    explicit PressureGauge(std::shared_ptr<Pressure> owner, bool counter) : _Owner(owner), _Counter(counter) {}
+
+    // A counter notifies on every sample, so CounterSlice sees the time advance; an average only when it changes.
+    void SetValue(metrics::DataType value) {
+      if (_Counter || _Value != value) {
+        _Value = value;
+        Notify();
+      }
+    }
+
+    std::chrono::steady_clock::time_point GetLastUpdate() const override { return _Owner->_LastUpdate; }
+    metrics::DataType GetValue() const override { return _Value; }
+
+  private:
+    // Hold the owner so the file stays open as long as the gauge is used.
+    std::shared_ptr<Pressure> _Owner;
+    const bool _Counter;
+    metrics::DataType _Value = 0;
+  };
+
+  static constexpr size_t KindCount = static_cast<size_t>(Kind::Count);
+  static constexpr size_t FieldCount = static_cast<size_t>(Field::Count);
+  static const std::array<const char*, static_cast<size_t>(Resource::Count)> _FileNames;
+
+  const Resource _Resource;
+  utils::FileHandle _Fd;
+  std::array<std::weak_ptr<PressureGauge>, KindCount * FieldCount> _Gauges;
+  std::chrono::steady_clock::time_point _LastUpdate;
+};
+
+} // namespace backend::system
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fcntl.h>
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+#include "../../utils/Error.hpp"
+#include "../metrics/Gauge.hpp"
+
+namespace backend::system {
+
+// A sampled value. Unlike SimpleGauge it notifies on every sample, even an unchanged one, so a CounterSlice over an
+// idle counter sees time pass and drops to 0.
+class SampleGauge : public metrics::Gauge {
+public:
+  explicit SampleGauge() = default;
+  ~SampleGauge() override = default;
+
+  void Set(metrics::DataType value, std::chrono::steady_clock::time_point time) {
+    _Value = value;
+    _LastUpdate = time;
+    Notify();
+  }
+
+  std::chrono::steady_clock::time_point GetLastUpdate() const override { return _LastUpdate; }
+  metrics::DataType GetValue() const override { return _Value; }
+
+private:
+  metrics::DataType _Value = 0;
+  std::chrono::steady_clock::time_point _LastUpdate;
+};
+
+// A system wide procfs file with one row per key (a CPU, a block device, a network interface) and a fixed set of
+// fields per row. Update rereads the whole file with one pread into a buffer kept across updates and parses it in
+// place; only rows seen for the first time allocate. Rows of keys gone from the file, e.g. the veth interfaces of
+// deleted containers, are dropped unless somebody holds one of their gauges.
+template <typename FieldT> class ProcTable {
+public:
+  using Field = FieldT;
+  static constexpr size_t FieldCount = static_cast<size_t>(Field::Count);
+  // The row summing up all others.
+  static constexpr std::string_view Total = "";
+
+  // Throws std::system_error when `path` can't be opened.
+  explicit ProcTable(const char* path) : _Fd(PosixE(open(path, O_RDONLY | O_CLOEXEC))) {}
+  virtual ~ProcTable() = default;
+
+  ProcTable(const ProcTable&) = delete;
+  ProcTable(ProcTable&&) = delete;
+  ProcTable& operator=(const ProcTable&) = delete;
+  ProcTable& operator=(ProcTable&&) = delete;
+
+  void Update() {
+    _Now = std::chrono::steady_clock::now();
+    if (auto text = Read(); !text.empty()) {
+      ++_Generation;
+      Parse(text);
+      Prune();
+    }
+  }
+
+  // Keys in the order they first appeared, without Total.
+  const std::vector<std::string>& GetKeys() const { return _KeyOrder; }
+
+  // Gauges of keys not seen yet stay 0 until the key shows up.
+  std::shared_ptr<metrics::Gauge> GetGauge(std::string_view key, Field field) {
+    return FindRow(key).Gauges[static_cast<size_t>(field)];
+  }
+
+protected:
+  struct Row {
+    std::array<std::shared_ptr<SampleGauge>, FieldCount> Gauges;
+    // The last Update whose file had this key.
+    uint64_t Generation = 0;
+  };
+
+  virtual void Parse(std::string_view text) = 0;
+
+  // The row of a key found in the file being parsed.
+  Row& GetRow(std::string_view key) {
+    auto& row = FindRow(key);
+    row.Generation = _Generation;
+    return row;
+  }
+
+  void Set(Row& row, Field field, metrics::DataType value) { row.Gauges[static_cast<size_t>(field)]->Set(value, _Now); }
+  std::chrono::steady_clock::time_point GetUpdateTime() const { return _Now; }
+
+  // Whether the sysfs directory `path` of a block device or network interface is backed by hardware, as opposed to
+  // loop, device mapper, veth or bridge devices, which only pass on what is counted elsewhere again. Totals sum only
+  // these to not count the same bytes twice.
+  bool IsPhysical(std::string_view name, const char* sysDir) {
+    if (auto it = _Physical.find(name); it != _Physical.end()) {
+      return it->second;
+    }
+    std::string path = std::string(sysDir) + "/" + std::string(name) + "/device";
+    return _Physical.emplace(name, access(path.c_str(), F_OK) == 0).first->second;
+  }
+
+private:
+  Row& FindRow(std::string_view key) {
+    if (auto it = _Rows.find(key); it != _Rows.end()) {
+      return it->second;
+    }
+
+    auto& row = _Rows[std::string(key)];
+    for (auto& gauge : row.Gauges) {
+      gauge = std::make_shared<SampleGauge>();
+    }
+    if (key != Total) {
+      _KeyOrder.emplace_back(key);
+    }
+    return row;
+  }
+
+  void Prune() {
+    auto held = [](const Row& row) {
+      return std::ranges::any_of(row.Gauges, [](auto& gauge) { return gauge.use_count() > 1; });
+    };
+    for (auto it = _Rows.begin(); it != _Rows.end();) {
+      if (it->first == Total || it->second.Generation == _Generation || held(it->second)) {
+        ++it;
+        continue;
+      }
+      std::erase(_KeyOrder, it->first);
+      if (auto physical = _Physical.find(it->first); physical != _Physical.end()) {
+        _Physical.erase(physical);
+      }
+      it = _Rows.erase(it);
+    }
+  }
+
+  std::string_view Read() {
+    while (true) {
+      ssize_t size = pread(_Fd, _Buffer.data(), _Buffer.size(), 0);
+      if (size < 0) {
+        return {};
+      }
+      if (static_cast<size_t>(size) < _Buffer.size()) {
+        return {_Buffer.data(), static_cast<size_t>(size)};
+      }
+      // Might have been cut short, e.g. /proc/stat of a machine with many CPUs.
+      _Buffer.resize(_Buffer.size() * 2);
+    }
+  }
+
+  utils::FileHandle _Fd;
+  std::vector<char> _Buffer = std::vector<char>(4096);
+  std::map<std::string, Row, std::less<>> _Rows;
+  std::vector<std::string> _KeyOrder;
+  uint64_t _Generation = 0;
+  std::chrono::steady_clock::time_point _Now;
+  std::map<std::string, bool, std::less<>> _Physical;
+};
+
+} // namespace backend::system
@@ -0,0 +1,162 @@
+// Samples a full process table once per tick, with and without an UpdateEpoch around the sampling pass, and prints
+// how many OnUpdate calls each pass causes: of the derived nodes, and of the subscribers drawing the cells.
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "../backend/metrics/Arithmetic.hpp"
+#include "../backend/metrics/Counter.hpp"
+#include "../backend/metrics/Expression.hpp"
+#include "../backend/metrics/Gauge.hpp"
+#include "../utils/Pool.hpp"
+
+namespace {
+
+namespace metrics = backend::metrics;
+namespace expr = backend::metrics::expr;
+
+constexpr size_t Rows = 60;
+// One process in BusyEvery changes its counters on every tick.
+constexpr size_t BusyEvery = 10;
+constexpr int Ticks = 5;
+constexpr std::chrono::seconds Period(1);
+
+uint64_t DerivedUpdates = 0;
+uint64_t SubscriberUpdates = 0;
+
+// Like ProcessGauge: a counter notifies on every sample, a level only when it changes.
+class SampleGauge : public metrics::Gauge {
+public:
+  explicit SampleGauge(bool counter) : _Counter(counter) {}
+
+  void Set(metrics::DataType value) {
+    bool changed = value != _Value;
+    _Value = value;
+    _LastUpdate = std::chrono::steady_clock::now();
+    if (_Counter || changed) {
+      Notify();
+    }
+  }
+
+  std::chrono::steady_clock::time_point GetLastUpdate() const override { return _LastUpdate; }
+  metrics::DataType GetValue() const override { return _Value; }
+
+private:
+  const bool _Counter;
+  std::chrono::steady_clock::time_point _LastUpdate = std::chrono::steady_clock::now();
+  metrics::DataType _Value = 0;
+};
+
+template <typename T> class Counted : public T {
+public:
+  using T::T;
+
+  void OnUpdate() override {
+    ++DerivedUpdates;
+    T::OnUpdate();
+  }
+};
+
+template <typename T, typename... Args> std::shared_ptr<T> MakeCounted(Args&&... args) {
+  return utils::MakePooled<Counted<T>>(std::forward<Args>(args)...);
+}
+
+template <typename E> std::shared_ptr<expr::Fused<E>> MakeCountedFused(E expression) {
+  return MakeCounted<expr::Fused<E>>(std::move(expression));
+}
+
+std::shared_ptr<SampleGauge> MakeCounter() { return utils::MakePooled<SampleGauge>(true); }
+std::shared_ptr<SampleGauge> MakeLevel() { return utils::MakePooled<SampleGauge>(false); }
+
+struct Process {
+  std::shared_ptr<SampleGauge> UserTime = MakeCounter();
+  std::shared_ptr<SampleGauge> SystemTime = MakeCounter();
+  std::shared_ptr<SampleGauge> Faults = MakeCounter();
+  std::shared_ptr<SampleGauge> ReadBytes = MakeCounter();
+  std::shared_ptr<SampleGauge> WriteBytes = MakeCounter();
+  std::shared_ptr<SampleGauge> State = MakeLevel();
+  std::shared_ptr<SampleGauge> Mem = MakeLevel();
+  std::shared_ptr<SampleGauge> Threads = MakeLevel();
+  std::shared_ptr<SampleGauge> VirtualSize = MakeLevel();
+
+  void Sample(metrics::DataType tick, bool busy) {
+    metrics::DataType progress = busy ? tick : 0;
+    UserTime->Set(progress * 3);
+    SystemTime->Set(progress);
+    Faults->Set(progress * 10);
+    ReadBytes->Set(progress * 4096);
+    WriteBytes->Set(progress * 512);
+    State->Set(busy ? 'R' : 'S');
+    Mem->Set(1000 + progress);
+    Threads->Set(1);
+    VirtualSize->Set(100000);
+  }
+};
+
+// The cells of the process table's columns, bound the way ProcessTree binds them.
+struct Row {
+  template <typename G> void Show(std::shared_ptr<G> gauge) {
+    Cells.push_back(metrics::MakeSubscriber(gauge, [](auto metric) {
+      ++SubscriberUpdates;
+      static_cast<void>(metric->GetValue());
+    }));
+  }
+
+  void Bind(const Process& process, std::shared_ptr<metrics::Gauge> jiffies, std::shared_ptr<metrics::Gauge> totalMem) {
+    Show(process.State);
+    Show(MakeCountedFused(expr::Ratio(
+        expr::Slice(expr::Of(process.UserTime) + expr::Of(process.SystemTime), Period), expr::Of(jiffies))));
+    Show(MakeCounted<metrics::Ratio>(process.Mem, totalMem));
+    Show(MakeCounted<metrics::CounterSlice>(process.Faults, Period));
+    Show(process.Threads);
+    Show(process.VirtualSize);
+    Show(MakeCounted<metrics::Plus>(process.UserTime, process.SystemTime));
+    Show(MakeCounted<metrics::CounterSlice>(process.ReadBytes, Period));
+    Show(MakeCounted<metrics::CounterSlice>(process.WriteBytes, Period));
+    Show(MakeCounted<metrics::Plus>(process.ReadBytes, process.WriteBytes));
+  }
+
+  std::vector<std::shared_ptr<metrics::SubscriberBase>> Cells;
+};
+
+void Run(bool epoch) {
+  auto jiffies = MakeCounter();
+  auto totalMem = MakeLevel();
+  totalMem->Set(1 << 20);
+  std::vector<Process> processes(Rows);
+  std::vector<Row> rows(Rows);
+  for (size_t i = 0; i < Rows; ++i) {
+    rows[i].Bind(processes[i], jiffies, totalMem);
+  }
+
+  std::printf("%s:\n", epoch ? "one UpdateEpoch per tick" : "no UpdateEpoch");
+  for (int tick = 1; tick <= Ticks; ++tick) {
+    DerivedUpdates = 0;
+    SubscriberUpdates = 0;
+    {
+      std::optional<metrics::UpdateEpoch> scope;
+      if (epoch) {
+        scope.emplace();
+      }
+      jiffies->Set(tick * 100);
+      for (size_t i = 0; i < Rows; ++i) {
+        processes[i].Sample(tick, i % BusyEvery == 0);
+      }
+    }
+    std::printf("  tick %d: %4llu derived node updates, %4llu subscriber callbacks, %4llu OnUpdate calls\n", tick,
+                static_cast<unsigned long long>(DerivedUpdates), static_cast<unsigned long long>(SubscriberUpdates),
+                static_cast<unsigned long long>(DerivedUpdates + SubscriberUpdates));
+  }
+}
+
+} // namespace
+
+int main() {
+  std::printf("%zu rows with 10 columns, one process in %zu busy\n", Rows, BusyEvery);
+  Run(false);
+  Run(true);
+  return 0;
+}
@@ -0,0 +1,139 @@
+// Rebinds every row of a process table on each tick, as scrolling does, with the metric chains of the %CPU, %MEM,
+// faults and TIME columns, and prints what the nodes cost per tick: blocks handed out by the pools, chunks they took
+// from the heap, and heap allocations overall. Once with the nodes from utils::MakePooled, once from
+// std::make_shared, side by side.
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "../backend/metrics/Arithmetic.hpp"
+#include "../backend/metrics/Counter.hpp"
+#include "../backend/metrics/Expression.hpp"
+#include "../backend/metrics/Gauge.hpp"
+#include "../utils/Pool.hpp"
+
+namespace {
+
+uint64_t HeapAllocations = 0;
+
+} // namespace
+
+void* operator new(size_t size) {
+  ++HeapAllocations;
+  if (void* block = std::malloc(size == 0 ? 1 : size)) {
+    return block;
+  }
+  throw std::bad_alloc();
+}
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete(void* block, size_t) noexcept { std::free(block); }
+
+namespace {
+
+namespace metrics = backend::metrics;
+namespace expr = backend::metrics::expr;
+
+constexpr size_t Rows = 60;
+constexpr size_t Processes = 500;
+constexpr int Ticks = 20;
+constexpr std::chrono::seconds Period(1);
+
+// The gauges of a process, pooled like ProcessGauge.
+struct Source {
+  std::shared_ptr<metrics::SimpleGauge> UserTime = utils::MakePooled<metrics::SimpleGauge>(0);
+  std::shared_ptr<metrics::SimpleGauge> SystemTime = utils::MakePooled<metrics::SimpleGauge>(0);
+  std::shared_ptr<metrics::SimpleGauge> Mem = utils::MakePooled<metrics::SimpleGauge>(0);
+  std::shared_ptr<metrics::SimpleGauge> Faults = utils::MakePooled<metrics::SimpleGauge>(0);
+};
+
+template <bool Pooled, typename T, typename... Args> std::shared_ptr<T> MakeNode(Args&&... args) {
+  if constexpr (Pooled) {
+    return utils::MakePooled<T>(std::forward<Args>(args)...);
+  } else {
+    return std::make_shared<T>(std::forward<Args>(args)...);
+  }
+}
+
+template <bool Pooled> struct Row {
+  void Bind(const Source& source, std::shared_ptr<metrics::Gauge> jiffies, std::shared_ptr<metrics::Gauge> totalMem) {
+    auto cpu = expr::Ratio(expr::Slice(expr::Of(source.UserTime) + expr::Of(source.SystemTime), Period),
+                           expr::Of(jiffies));
+    Cpu = metrics::MakeSubscriber(MakeNode<Pooled, expr::Fused<decltype(cpu)>>(std::move(cpu)),
+                                  [this](auto metric) { Shown[0] = metric->GetValue(); });
+    Mem = metrics::MakeSubscriber(MakeNode<Pooled, metrics::Ratio>(source.Mem, totalMem),
+                                  [this](auto metric) { Shown[1] = metric->GetValue(); });
+    Faults = metrics::MakeSubscriber(MakeNode<Pooled, metrics::CounterSlice>(source.Faults, Period),
+                                     [this](auto metric) { Shown[2] = metric->GetValue(); });
+    Time = metrics::MakeSubscriber(MakeNode<Pooled, metrics::Plus>(source.UserTime, source.SystemTime),
+                                   [this](auto metric) { Shown[3] = metric->GetValue(); });
+  }
+
+  std::shared_ptr<metrics::SubscriberBase> Cpu;
+  std::shared_ptr<metrics::SubscriberBase> Mem;
+  std::shared_ptr<metrics::SubscriberBase> Faults;
+  std::shared_ptr<metrics::SubscriberBase> Time;
+  metrics::DataType Shown[4] = {};
+};
+
+struct Tick {
+  uint64_t PooledBlocks;
+  uint64_t Chunks;
+  uint64_t HeapAllocations;
+  double Microseconds;
+};
+
+template <bool Pooled> std::vector<Tick> Run() {
+  auto jiffies = utils::MakePooled<metrics::SimpleGauge>(0);
+  auto totalMem = utils::MakePooled<metrics::SimpleGauge>(1 << 20);
+  std::vector<Source> sources(Processes);
+  std::vector<Row<Pooled>> rows(Rows);
+
+  std::vector<Tick> ticks;
+  for (int tick = 0; tick < Ticks; ++tick) {
+    {
+      metrics::UpdateEpoch epoch;
+      jiffies->Update((tick + 1) * 100);
+      for (size_t i = 0; i < Processes; ++i) {
+        sources[i].UserTime->Update(tick * (i % 7));
+        sources[i].SystemTime->Update(tick * (i % 3));
+        sources[i].Mem->Update(1000 + i);
+        sources[i].Faults->Update(tick * (i % 5));
+      }
+    }
+
+    auto pool = utils::Pool::GetTotalStats();
+    auto heap = HeapAllocations;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < Rows; ++i) {
+      rows[i].Bind(sources[(tick + i) % Processes], jiffies, totalMem);
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    auto after = utils::Pool::GetTotalStats();
+    ticks.push_back(
+        {after.Allocations - pool.Allocations, after.Chunks - pool.Chunks, HeapAllocations - heap, elapsed});
+  }
+  return ticks;
+}
+
+} // namespace
+
+int main() {
+  auto pooled = Run<true>();
+  auto shared = Run<false>();
+
+  std::printf("%d ticks, %zu rows rebound per tick out of %zu processes\n", Ticks, Rows, Processes);
+  std::printf("         %-45s | %s\n", "MakePooled", "make_shared");
+  for (int tick = 0; tick < Ticks; ++tick) {
+    auto& p = pooled[tick];
+    auto& s = shared[tick];
+    std::printf("tick %2d: %4llu pooled, %2llu chunks, %4llu heap, %6.1f us | %4llu heap, %6.1f us\n", tick,
+                static_cast<unsigned long long>(p.PooledBlocks), static_cast<unsigned long long>(p.Chunks),
+                static_cast<unsigned long long>(p.HeapAllocations), p.Microseconds,
+                static_cast<unsigned long long>(s.HeapAllocations), s.Microseconds);
+  }
+  return 0;
+}
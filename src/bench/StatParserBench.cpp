@@ -0,0 +1,144 @@
+// Compares StatParser with the path it replaced, an ifstream read into a string and parsed with istringstream, on the
+// /proc/<pid>/stat of the processes running now: parsing alone, and reading plus parsing each file.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "../backend/process/StatParser.hpp"
+
+namespace {
+
+using backend::process::ProcessStat;
+using backend::process::StatParser;
+
+// As Process::ParseStatFile did before StatParser.
+bool ParseWithStreams(const std::string& content, ProcessStat& ps, std::string& comm) {
+  auto start = content.find_first_of('(');
+  auto end = content.find_last_of(')');
+  if (start == std::string::npos || end == std::string::npos) {
+    return false;
+  }
+
+  std::istringstream beforeComm(content.substr(0, start));
+  std::istringstream afterComm(content.substr(end + 1, content.length() - (end + 1)));
+
+  beforeComm >> ps.pid;
+  comm = content.substr(start, end - start + 1);
+  afterComm >> ps.state >> ps.ppid >> ps.pgrp >> ps.session >> ps.tty_nr >> ps.tpgid >> ps.flags >> ps.minflt >>
+      ps.cminflt >> ps.majflt >> ps.cmajflt >> ps.utime >> ps.stime >> ps.cutime >> ps.cstime >> ps.priority >>
+      ps.nice >> ps.num_threads >> ps.itrealvalue >> ps.starttime >> ps.vsize >> ps.rss;
+  return !afterComm.fail();
+}
+
+bool ReadWithStreams(const std::string& path, ProcessStat& ps, std::string& comm) {
+  std::ifstream ifs(path);
+  if (!ifs.is_open()) {
+    return false;
+  }
+  std::string content(std::istreambuf_iterator<char>(ifs), {});
+  return ParseWithStreams(content, ps, comm);
+}
+
+// As Process reads through ProcFiles: the descriptor stays open and the file is read again from offset 0.
+bool ReadWithParser(int fd, ProcessStat& ps) {
+  StatParser::Buffer buffer;
+  ssize_t size = pread(fd, buffer.data(), buffer.size(), 0);
+  return size > 0 && StatParser::Parse({buffer.data(), static_cast<size_t>(size)}, ps);
+}
+
+std::vector<std::string> ListPids() {
+  std::vector<std::string> pids;
+  DIR* dir = opendir("/proc");
+  if (!dir) {
+    return pids;
+  }
+  while (auto entry = readdir(dir)) {
+    if (entry->d_name[0] >= '1' && entry->d_name[0] <= '9') {
+      pids.emplace_back(entry->d_name);
+    }
+  }
+  closedir(dir);
+  return pids;
+}
+
+// Runs `f` `iterations` times and returns the nanoseconds per call of `f` per item.
+template <typename F> double Measure(int iterations, size_t items, F&& f) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    f();
+  }
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / iterations / items;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 200;
+
+  std::vector<std::string> paths;
+  std::vector<std::string> lines;
+  std::vector<int> fds;
+  for (auto& pid : ListPids()) {
+    std::string path = "/proc/" + pid + "/stat";
+    std::ifstream ifs(path);
+    std::string line(std::istreambuf_iterator<char>(ifs), {});
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (line.empty() || fd < 0) {
+      if (fd >= 0) {
+        close(fd);
+      }
+      continue;
+    }
+    paths.push_back(std::move(path));
+    lines.push_back(std::move(line));
+    fds.push_back(fd);
+  }
+  if (lines.empty()) {
+    std::fprintf(stderr, "no readable /proc/<pid>/stat\n");
+    return 1;
+  }
+
+  // Sums a field of every result, so the parsing is not optimized away.
+  unsigned long checksum = 0;
+  ProcessStat ps = {};
+  std::string comm;
+
+  double parseStreams = Measure(iterations, lines.size(), [&] {
+    for (auto& line : lines) {
+      checksum += ParseWithStreams(line, ps, comm) ? ps.utime : 0;
+    }
+  });
+  double parseParser = Measure(iterations, lines.size(), [&] {
+    for (auto& line : lines) {
+      checksum += StatParser::Parse(line, ps) ? ps.utime : 0;
+    }
+  });
+  double readStreams = Measure(iterations, paths.size(), [&] {
+    for (auto& path : paths) {
+      checksum += ReadWithStreams(path, ps, comm) ? ps.utime : 0;
+    }
+  });
+  double readParser = Measure(iterations, fds.size(), [&] {
+    for (int fd : fds) {
+      checksum += ReadWithParser(fd, ps) ? ps.utime : 0;
+    }
+  });
+
+  for (int fd : fds) {
+    close(fd);
+  }
+
+  std::printf("%zu processes, %d iterations (checksum %lu)\n", lines.size(), iterations, checksum);
+  std::printf("parse only:  istringstream %7.0f ns/line, StatParser %7.0f ns/line\n", parseStreams, parseParser);
+  std::printf("read+parse:  ifstream      %7.0f ns/proc, StatParser %7.0f ns/proc\n", readStreams, readParser);
+  return 0;
+}
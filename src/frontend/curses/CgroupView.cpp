@@ -0,0 +1,397 @@
+#include "CgroupView.hpp"
+
+#include <algorithm>
+#include <format>
+
+#include "../../backend/metrics/Arithmetic.hpp"
+#include "../../backend/metrics/Counter.hpp"
+#include "../../utils/Formatter.hpp"
+#include "../../utils/Pool.hpp"
+#include "OmniMon.hpp"
+#include "Options.hpp"
+
+namespace frontend::curses {
+
+using backend::cgroup::Cgroup;
+
+class CgroupCell {
+public:
+  virtual ~CgroupCell() = default;
+  virtual std::shared_ptr<View> GetView() const = 0;
+  virtual void BindCgroup(CgroupView& view, CgroupView::RowBinding& row, std::shared_ptr<Cgroup> cgroup) = 0;
+};
+
+class CgroupColumn : public Column {
+public:
+  explicit CgroupColumn(Table& table, Container::ArrangementType arrangement, DisplayLength width)
+      : Column(table, arrangement, width) {}
+  ~CgroupColumn() override = default;
+
+  DisplayLength GetMarginAfter() const override { return 1; }
+  virtual std::shared_ptr<View> HeaderView() const = 0;
+  virtual std::shared_ptr<CgroupCell> CreateCell() = 0;
+};
+
+class CgroupColumnCursor : public CgroupColumn {
+public:
+  explicit CgroupColumnCursor(Table& table) : CgroupColumn(table, Container::ArrangementType::Forward, 1) {}
+  ~CgroupColumnCursor() override = default;
+
+  std::shared_ptr<View> HeaderView() const override {
+    auto cell = std::make_shared<TextView>(TextView::Align::Left);
+    cell->SetText("☰");
+    return cell;
+  }
+
+  std::shared_ptr<CgroupCell> CreateCell() override { return std::make_shared<Cell>(); }
+
+  class Cell : public CgroupCell {
+  public:
+    Cell() : _View(std::make_shared<TextView>(TextView::Align::Left)) {}
+    std::shared_ptr<View> GetView() const override { return _View; }
+    void BindCgroup(CgroupView& view, CgroupView::RowBinding& row, std::shared_ptr<Cgroup> cgroup) override {
+      _CursorUpdater = backend::metrics::MakeSubscriber(view.GetCursor(), [this, &row](auto metric) {
+        _View->SetText(metric->GetValue() == row.GetIndex() ? "⮚" : "");
+      });
+    }
+
+  private:
+    std::shared_ptr<TextView> _View;
+    std::shared_ptr<backend::metrics::SubscriberBase> _CursorUpdater;
+  };
+};
+
+// A right aligned number computed from the gauges of one cgroup.
+class CgroupColumnGauge : public CgroupColumn {
+public:
+  explicit CgroupColumnGauge(Table& table, DisplayLength width, const char* header)
+      : CgroupColumn(table, Container::ArrangementType::Forward, width), _Header(header) {}
+  ~CgroupColumnGauge() override = default;
+
+  std::shared_ptr<View> HeaderView() const override {
+    auto cell = std::make_shared<TextView>(TextView::Align::Right);
+    cell->SetText(_Header);
+    return cell;
+  }
+
+  std::shared_ptr<CgroupCell> CreateCell() override { return std::make_shared<Cell>(*this); }
+
+  // nullptr leaves the cell empty.
+  virtual std::shared_ptr<backend::metrics::Gauge> MakeGauge(std::shared_ptr<Cgroup> cgroup) const = 0;
+  virtual std::string Format(backend::metrics::DataType value) const = 0;
+
+  class Cell : public CgroupCell {
+  public:
+    explicit Cell(CgroupColumnGauge& column)
+        : _Column(column), _View(std::make_shared<TextView>(TextView::Align::Right)) {}
+    ~Cell() override = default;
+
+    std::shared_ptr<View> GetView() const override { return _View; }
+    void BindCgroup(CgroupView& view, CgroupView::RowBinding& row, std::shared_ptr<Cgroup> cgroup) override {
+      if (auto gauge = cgroup ? _Column.MakeGauge(cgroup) : nullptr) {
+        _Updater = backend::metrics::MakeSubscriber(
+            gauge, [this](auto metric) { _View->SetText(_Column.Format(metric->GetValue())); });
+      } else {
+        _Updater.reset();
+        _View->SetText("");
+      }
+    }
+
+  private:
+    CgroupColumnGauge& _Column;
+    std::shared_ptr<TextView> _View;
+    std::shared_ptr<backend::metrics::SubscriberBase> _Updater;
+  };
+
+protected:
+  // Share of one CPU spent in the microsecond counter `field`, over the last refresh interval.
+  static std::shared_ptr<backend::metrics::Gauge> CpuShare(std::shared_ptr<Cgroup> cgroup, Cgroup::Field field) {
+    auto interval = Config::GetInstance().RefreshInterval;
+    return utils::MakePooled<backend::metrics::Ratio>(
+        utils::MakePooled<backend::metrics::CounterSlice>(Cgroup::GetGauge(cgroup, field), interval),
+        std::make_shared<backend::metrics::ConstGauge>(
+            std::chrono::duration_cast<std::chrono::microseconds>(interval).count()));
+  }
+
+  static std::string Percent(backend::metrics::DataType value) { return std::format("{:.{}f}", value / 100.0f, 1); }
+
+private:
+  const char* _Header;
+};
+
+class CgroupColumnCpu : public CgroupColumnGauge {
+public:
+  explicit CgroupColumnCpu(Table& table) : CgroupColumnGauge(table, 5, "%CPU") {}
+
+  std::shared_ptr<backend::metrics::Gauge> MakeGauge(std::shared_ptr<Cgroup> cgroup) const override {
+    return CpuShare(cgroup, Cgroup::Field::CpuUsage);
+  }
+  std::string Format(backend::metrics::DataType value) const override { return Percent(value); }
+};
+
+class CgroupColumnThrottled : public CgroupColumnGauge {
+public:
+  explicit CgroupColumnThrottled(Table& table) : CgroupColumnGauge(table, 5, "%Thr") {}
+
+  // Wall time throttled, summed over the CPUs it was throttled on, like %CPU.
+  std::shared_ptr<backend::metrics::Gauge> MakeGauge(std::shared_ptr<Cgroup> cgroup) const override {
+    return CpuShare(cgroup, Cgroup::Field::CpuThrottledTime);
+  }
+  std::string Format(backend::metrics::DataType value) const override { return Percent(value); }
+};
+
+class CgroupColumnMemory : public CgroupColumnGauge {
+public:
+  explicit CgroupColumnMemory(Table& table) : CgroupColumnGauge(table, 5, "Mem") {}
+
+  std::shared_ptr<backend::metrics::Gauge> MakeGauge(std::shared_ptr<Cgroup> cgroup) const override {
+    return Cgroup::GetGauge(cgroup, Cgroup::Field::MemoryCurrent);
+  }
+  std::string Format(backend::metrics::DataType value) const override { return utils::DiskSizeToString(value, 5); }
+};
+
+class CgroupColumnDiskRead : public CgroupColumnGauge {
+public:
+  explicit CgroupColumnDiskRead(Table& table) : CgroupColumnGauge(table, 5, "DiskR") {}
+
+  std::shared_ptr<backend::metrics::Gauge> MakeGauge(std::shared_ptr<Cgroup> cgroup) const override {
+    return utils::MakePooled<backend::metrics::CounterSlice>(Cgroup::GetGauge(cgroup, Cgroup::Field::IoReadBytes),
+                                                             Config::GetInstance().RefreshInterval);
+  }
+  std::string Format(backend::metrics::DataType value) const override { return utils::DiskSizeToString(value, 5); }
+};
+
+class CgroupColumnDiskWrite : public CgroupColumnGauge {
+public:
+  explicit CgroupColumnDiskWrite(Table& table) : CgroupColumnGauge(table, 5, "DiskW") {}
+
+  std::shared_ptr<backend::metrics::Gauge> MakeGauge(std::shared_ptr<Cgroup> cgroup) const override {
+    return utils::MakePooled<backend::metrics::CounterSlice>(Cgroup::GetGauge(cgroup, Cgroup::Field::IoWriteBytes),
+                                                             Config::GetInstance().RefreshInterval);
+  }
+  std::string Format(backend::metrics::DataType value) const override { return utils::DiskSizeToString(value, 5); }
+};
+
+// Share of time some task of the cgroup stalled on the resource, averaged over 10s.
+class CgroupColumnPressure : public CgroupColumnGauge {
+public:
+  explicit CgroupColumnPressure(Table& table, const char* header, backend::system::Pressure::Resource resource)
+      : CgroupColumnGauge(table, 5, header), _Resource(resource) {}
+
+  std::shared_ptr<backend::metrics::Gauge> MakeGauge(std::shared_ptr<Cgroup> cgroup) const override {
+    auto pressure = cgroup->GetPressure(_Resource);
+    return pressure ? backend::system::Pressure::GetGauge(pressure, backend::system::Pressure::Kind::Some,
+                                                          backend::system::Pressure::Field::Avg10)
+                    : nullptr;
+  }
+  std::string Format(backend::metrics::DataType value) const override { return Percent(value); }
+
+private:
+  const backend::system::Pressure::Resource _Resource;
+};
+
+class CgroupColumnCpuPressure : public CgroupColumnPressure {
+public:
+  explicit CgroupColumnCpuPressure(Table& table)
+      : CgroupColumnPressure(table, "PsiC", backend::system::Pressure::Resource::Cpu) {}
+};
+
+class CgroupColumnMemoryPressure : public CgroupColumnPressure {
+public:
+  explicit CgroupColumnMemoryPressure(Table& table)
+      : CgroupColumnPressure(table, "PsiM", backend::system::Pressure::Resource::Memory) {}
+};
+
+class CgroupColumnIoPressure : public CgroupColumnPressure {
+public:
+  explicit CgroupColumnIoPressure(Table& table)
+      : CgroupColumnPressure(table, "PsiI", backend::system::Pressure::Resource::Io) {}
+};
+
+class CgroupColumnName : public CgroupColumn {
+public:
+  explicit CgroupColumnName(Table& table) : CgroupColumn(table, Container::ArrangementType::FillRest, 1) {}
+  ~CgroupColumnName() override = default;
+  DisplayLength GetMarginAfter() const override { return 0; }
+
+  std::shared_ptr<View> HeaderView() const override {
+    auto cell = std::make_shared<TextView>(TextView::Align::Left);
+    cell->SetText("Cgroup");
+    return cell;
+  }
+
+  std::shared_ptr<CgroupCell> CreateCell() override { return std::make_shared<Cell>(); }
+
+  class Cell : public CgroupCell {
+  public:
+    Cell() : _View(std::make_shared<TextView>(TextView::Align::Left)) {}
+    std::shared_ptr<View> GetView() const override { return _View; }
+    void BindCgroup(CgroupView& view, CgroupView::RowBinding& row, std::shared_ptr<Cgroup> cgroup) override {
+      if (!cgroup) {
+        _View->SetText("");
+      } else if (cgroup->GetPath().empty()) {
+        _View->SetText("/");
+      } else {
+        _View->SetText(std::format("{}{}", TreeString(cgroup), cgroup->GetName()));
+      }
+    }
+
+  private:
+    static bool IsLast(const Cgroup& cgroup) {
+      auto& siblings = cgroup.GetParent()->GetChildren();
+      return siblings.empty() || std::prev(siblings.end())->second.get() == &cgroup;
+    }
+
+    static std::string TreeString(std::shared_ptr<Cgroup> cgroup) {
+      std::string result = IsLast(*cgroup) ? "└─" : "├─";
+      for (auto parent = cgroup->GetParent(); parent->GetParent(); parent = parent->GetParent()) {
+        result.insert(0, IsLast(*parent) ? "  " : "│ ");
+      }
+      return result;
+    }
+
+    std::shared_ptr<TextView> _View;
+  };
+};
+
+void CgroupEventHandle::OnRead() {
+  _Tree.Receive(_Fd);
+  ScheduleRead();
+}
+
+void CgroupEventHandle::OnWrite() {
+  // This should never happen.
+  throw std::runtime_error("CgroupEventHandle::OnWrite");
+}
+
+CgroupView::CgroupView(EventLoop& loop)
+    : _TableInputHandler(std::make_shared<TableInputHandler>(*this)),
+      _Table(_TableInputHandler,
+             ColumnBuilder<CgroupColumnCursor, CgroupColumnCpu, CgroupColumnThrottled, CgroupColumnMemory,
+                           CgroupColumnDiskRead, CgroupColumnDiskWrite, CgroupColumnCpuPressure,
+                           CgroupColumnMemoryPressure, CgroupColumnIoPressure, CgroupColumnName>()),
+      _Cursor(std::make_shared<backend::metrics::SimpleGauge>()) {
+  _Table.AppendRow(std::make_shared<HeaderBinding>());
+
+  try {
+    _Tree.emplace();
+  } catch (const std::system_error&) {
+    // No cgroup2 mount, e.g. a legacy v1 only system.
+    return;
+  }
+
+  if (int fd = _Tree->OpenWatcher(); fd >= 0) {
+    _EventHandle = std::make_unique<CgroupEventHandle>(loop, fd, *_Tree);
+  }
+}
+
+std::shared_ptr<View> CgroupView::GetView() const { return _Table.GetTableContainer(); }
+
+DisplayLength CgroupView::GetHeight() const { return _Table.GetTableContainer()->GetLayout().Height - 1; }
+
+void CgroupView::Update() {
+  if (!_Tree || GetHeight() <= 0) {
+    return;
+  }
+
+  _Tree->Update();
+  UpdateTable();
+}
+
+void CgroupView::UpdateTable() {
+  // Keep the selected cgroup under the cursor if it is still there.
+  std::shared_ptr<Cgroup> selected;
+  if (_Top + _Cursor->GetValue() < _Cgroups.size()) {
+    selected = _Cgroups[_Top + _Cursor->GetValue()];
+  }
+
+  _Cgroups.clear();
+  _Tree->Flatten(_Cgroups);
+
+  size_t height = GetHeight();
+  if (auto it = std::ranges::find(_Cgroups, selected); selected && it != _Cgroups.end()) {
+    size_t position = it - _Cgroups.begin();
+    _Top = position >= _Cursor->GetValue() ? position - _Cursor->GetValue() : 0;
+  }
+  _Top = std::min(_Top, _Cgroups.size() > height ? _Cgroups.size() - height : 0);
+  size_t rows = std::min(height, _Cgroups.size() - _Top);
+  if (_Cursor->GetValue() >= rows) {
+    _Cursor->Update(rows > 0 ? rows - 1 : 0);
+  }
+
+  for (size_t i = 0; i < std::max(rows, _Rows.size()); ++i) {
+    auto cgroup = i < rows ? _Cgroups[_Top + i] : nullptr;
+    if (i < _Rows.size()) {
+      _Rows[i]->UpdateCgroup(cgroup);
+    } else {
+      auto row = std::make_shared<RowBinding>(*this, i, cgroup);
+      _Rows.push_back(row);
+      _Table.AppendRow(row);
+    }
+  }
+}
+
+bool CgroupView::OnKey(TermKeyCode key) {
+  switch (key) {
+  case KEY_UP:
+    MoveCursor(-1);
+    return true;
+  case KEY_DOWN:
+    MoveCursor(1);
+    return true;
+  case KEY_PPAGE:
+    MoveCursor(-GetHeight());
+    return true;
+  case KEY_NPAGE:
+    MoveCursor(GetHeight());
+    return true;
+  default:
+    return false;
+  }
+}
+
+void CgroupView::MoveCursor(DisplayLength offset) {
+  if (_Cgroups.empty()) {
+    return;
+  }
+
+  DisplayLength height = GetHeight();
+  DisplayLength position = std::clamp<DisplayLength>(_Top + _Cursor->GetValue() + offset, 0, _Cgroups.size() - 1);
+  DisplayLength top = _Top;
+  if (position < top) {
+    top = position;
+  } else if (position >= top + height) {
+    top = position - height + 1;
+  }
+  _Top = top;
+  _Cursor->Update(position - top);
+  UpdateTable();
+  OmniMon::GetInstance().ScheduleDraw();
+}
+
+std::shared_ptr<View> CgroupView::HeaderBinding::OnNewCell(Table& table, Row& row, Column& column) {
+  return dynamic_cast<CgroupColumn&>(column).HeaderView();
+}
+
+CgroupView::RowBinding::RowBinding(CgroupView& view, size_t index, std::shared_ptr<Cgroup> cgroup)
+    : _View(view), _Index(index), _Cgroup(cgroup) {}
+
+std::shared_ptr<View> CgroupView::RowBinding::OnNewCell(Table& table, Row& row, Column& column) {
+  std::shared_ptr<CgroupCell> cell = dynamic_cast<CgroupColumn&>(column).CreateCell();
+  _Cells.push_back(cell);
+  cell->BindCgroup(_View, *this, _Cgroup);
+  return cell->GetView();
+}
+
+void CgroupView::RowBinding::UpdateCgroup(std::shared_ptr<Cgroup> cgroup) {
+  if (_Cgroup != cgroup) {
+    for (auto cell : _Cells) {
+      cell->BindCgroup(_View, *this, cgroup);
+    }
+    _Cgroup = cgroup;
+  }
+}
+
+bool CgroupView::TableInputHandler::OnKey(TermKeyCode key) { return _CgroupView.OnKey(key); }
+
+} // namespace frontend::curses
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "../../backend/cgroup/CgroupTree.hpp"
+#include "../../backend/metrics/Gauge.hpp"
+#include "Events.hpp"
+#include "layouts/Table.hpp"
+
+namespace frontend::curses {
+
+class CgroupCell;
+
+class CgroupEventHandle : public EventHandle {
+public:
+  explicit CgroupEventHandle(EventLoop& loop, int fd, backend::cgroup::CgroupTree& tree)
+      : EventHandle(loop, fd), _Tree(tree) {
+    ScheduleRead();
+  }
+  ~CgroupEventHandle() override = default;
+
+  void OnRead() override;
+  void OnWrite() override;
+
+private:
+  backend::cgroup::CgroupTree& _Tree;
+};
+
+// The cgroup v2 hierarchy as a tree table, with the resource usage of each cgroup including its descendants.
+class CgroupView {
+public:
+  explicit CgroupView(EventLoop& loop);
+
+  class HeaderBinding : public TableBinding {
+  public:
+    explicit HeaderBinding() = default;
+    ~HeaderBinding() override = default;
+
+    bool OnKey(TermKeyCode key) override { return false; }
+    std::shared_ptr<View> OnNewCell(Table& table, Row& row, Column& column) override;
+  };
+
+  class RowBinding : public TableBinding {
+  public:
+    explicit RowBinding(CgroupView& view, size_t index, std::shared_ptr<backend::cgroup::Cgroup> cgroup);
+    ~RowBinding() override = default;
+
+    size_t GetIndex() const { return _Index; }
+    bool OnKey(TermKeyCode key) override { return false; }
+    std::shared_ptr<View> OnNewCell(Table& table, Row& row, Column& column) override;
+    void UpdateCgroup(std::shared_ptr<backend::cgroup::Cgroup> cgroup);
+
+  private:
+    CgroupView& _View;
+    size_t _Index;
+    std::shared_ptr<backend::cgroup::Cgroup> _Cgroup;
+    std::vector<std::shared_ptr<CgroupCell>> _Cells;
+  };
+
+  class TableInputHandler : public InputHandler {
+  public:
+    explicit TableInputHandler(CgroupView& view) : _CgroupView(view) {}
+    ~TableInputHandler() override = default;
+
+    bool OnKey(TermKeyCode key) override;
+
+  private:
+    CgroupView& _CgroupView;
+  };
+
+  // False when there is no cgroup v2 hierarchy to show.
+  bool IsAvailable() const { return _Tree.has_value(); }
+  std::shared_ptr<View> GetView() const;
+  void Update();
+  bool OnKey(TermKeyCode key);
+  std::shared_ptr<backend::metrics::Gauge> GetCursor() const { return _Cursor; };
+
+private:
+  DisplayLength GetHeight() const;
+  void UpdateTable();
+  void MoveCursor(DisplayLength offset);
+
+  std::optional<backend::cgroup::CgroupTree> _Tree;
+  std::unique_ptr<CgroupEventHandle> _EventHandle;
+  std::shared_ptr<InputHandler> _TableInputHandler;
+  Table _Table;
+  std::shared_ptr<backend::metrics::SimpleGauge> _Cursor;
+  std::vector<std::shared_ptr<RowBinding>> _Rows;
+  // All cgroups in display order, and the index of the first one on screen.
+  std::vector<std::shared_ptr<backend::cgroup::Cgroup>> _Cgroups;
+  size_t _Top = 0;
+};
+
+} // namespace frontend::curses
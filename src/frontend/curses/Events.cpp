@@ -33,6 +33,16 @@ void EventHandle::ScheduleWrite() {
   _Loop.ChangeHandle(*this);
 }
 
+void EventHandle::SchedulePriority() {
+  _PriorityScheduled = true;
+  _Loop.ChangeHandle(*this);
+}
+
+void EventHandle::OnPriority() {
+  // This should never happen, only handles calling SchedulePriority get here.
+  throw std::runtime_error("EventHandle::OnPriority");
+}
+
 void EventHandle::OnEvent(uint32_t events) {
   if (events & EPOLL_EVENTS::EPOLLIN) {
     _ReadScheduled = false;
@@ -40,6 +50,9 @@ void EventHandle::OnEvent(uint32_t events) {
   if (events & EPOLL_EVENTS::EPOLLOUT) {
     _WriteScheduled = false;
   }
+  if (events & EPOLL_EVENTS::EPOLLPRI) {
+    _PriorityScheduled = false;
+  }
 
   _Loop.ChangeHandle(*this);
 
@@ -49,6 +62,9 @@ void EventHandle::OnEvent(uint32_t events) {
   if (events & EPOLL_EVENTS::EPOLLOUT) {
     OnWrite();
   }
+  if (events & EPOLL_EVENTS::EPOLLPRI) {
+    OnPriority();
+  }
 }
 
 // Notification
@@ -174,6 +190,9 @@ void EventLoop::ChangeHandle(EventHandle& handle) {
   if (handle._WriteScheduled) {
     event.events |= EPOLL_EVENTS::EPOLLOUT;
   }
+  if (handle._PriorityScheduled) {
+    event.events |= EPOLL_EVENTS::EPOLLPRI;
+  }
   PosixE(epoll_ctl(_EpollFd, EPOLL_CTL_MOD, handle._Fd, &event));
 }
 
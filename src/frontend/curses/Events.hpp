@@ -23,8 +23,11 @@ public:
 
   void ScheduleRead();
   void ScheduleWrite();
+  // Waits for urgent data, EPOLLPRI, which is how PSI triggers signal.
+  void SchedulePriority();
   virtual void OnRead() = 0;
   virtual void OnWrite() = 0;
+  virtual void OnPriority();
 
 protected:
   friend class EventLoop;
@@ -34,6 +37,7 @@ protected:
   utils::FileHandle _Fd;
   bool _ReadScheduled = false;
   bool _WriteScheduled = false;
+  bool _PriorityScheduled = false;
 };
 
 class EventNotification : public EventHandle {
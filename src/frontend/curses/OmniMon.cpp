@@ -1,5 +1,7 @@
 #include "OmniMon.hpp"
 
+#include "../../backend/metrics/Binding.hpp"
+
 namespace frontend::curses {
 
 void Timer::OnTimer() { _OmniMon.Update(); }
@@ -10,18 +12,36 @@ OmniMon& OmniMon::GetInstance() {
 }
 
 OmniMon::OmniMon()
-    : _Loop(), _SigInt(_Loop), _Curses(_Loop), _Timer(_Loop, *this), _ProcessTree(std::make_shared<ProcessTree>()),
-      _Screen(std::make_shared<Screen>(*this, _ProcessTree)) {
+    : _Loop(), _SigInt(_Loop), _Curses(_Loop), _Timer(_Loop, *this),
+      _SystemPane(std::make_shared<SystemPane>()), _PressurePane(std::make_shared<PressurePane>(_Loop)),
+      _ProcessTree(std::make_shared<ProcessTree>(_Loop)), _CgroupView(std::make_shared<CgroupView>(_Loop)),
+      _Screen(std::make_shared<Screen>(*this, _SystemPane, _PressurePane, _ProcessTree, _CgroupView)) {
   _Curses.SetRoot(_Screen);
 }
 
 void OmniMon::ScheduleDraw() { _Curses.ScheduleDraw(); }
 
 void OmniMon::Update() {
-  _ProcessTree->Update();
+  {
+    // Subscribers see the whole refresh at once, each dirty gauge notifies them a single time.
+    backend::metrics::UpdateEpoch epoch;
+    UpdateCollectors();
+  }
+  _SystemPane->Refresh();
   Draw();
 }
 
+void OmniMon::UpdateCollectors() {
+  _SystemPane->Update();
+  _PressurePane->Update();
+  // Only the page on screen is kept up to date.
+  if (_Screen->GetPage() == Screen::Page::Cgroups) {
+    _CgroupView->Update();
+  } else {
+    _ProcessTree->Update();
+  }
+}
+
 void OmniMon::Draw() { _Curses.Update(); }
 
 } // namespace frontend::curses
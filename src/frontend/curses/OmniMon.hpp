@@ -2,10 +2,13 @@
 
 #include <signal.h>
 
+#include "CgroupView.hpp"
 #include "Events.hpp"
 #include "Options.hpp"
+#include "PressurePane.hpp"
 #include "ProcessTree.hpp"
 #include "Screen.hpp"
+#include "SystemPane.hpp"
 #include "layouts/Curses.hpp"
 
 namespace frontend::curses {
@@ -50,12 +53,17 @@ public:
   void Stop() { _Loop.Stop(); }
 
 private:
+  void UpdateCollectors();
+
   EventLoop _Loop;
   // Signal handlers must be created before the curses instance.
   SigInt _SigInt;
   Curses _Curses;
   Timer _Timer;
+  std::shared_ptr<SystemPane> _SystemPane;
+  std::shared_ptr<PressurePane> _PressurePane;
   std::shared_ptr<ProcessTree> _ProcessTree;
+  std::shared_ptr<CgroupView> _CgroupView;
   std::shared_ptr<Screen> _Screen;
 };
 
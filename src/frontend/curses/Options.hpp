@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 
 namespace frontend::curses {
 
@@ -9,6 +10,23 @@ public:
   static Config GetInstance();
 
   std::chrono::steady_clock::duration RefreshInterval = std::chrono::seconds(1);
+  // Track process creation with the proc connector instead of rescanning /proc on every refresh, when permitted.
+  bool UseProcConnector = true;
+  // Collect all process statistics with one BPF task iterator pass instead of reading /proc/<pid>, when permitted.
+  bool UseBpfTaskIterator = true;
+  // Fetch delay accounting and the final accounting of exiting processes from taskstats, when permitted.
+  bool UseTaskstats = true;
+  // Read /proc/<pid> files in batches through io_uring instead of one pread each, when supported.
+  bool UseIoUring = true;
+  // Processes nobody is looking at are read at this slower interval. Processes on screen are read every refresh.
+  std::chrono::steady_clock::duration SlowSamplingInterval = std::chrono::seconds(5);
+  // Threads sampling /proc/<pid> files, including the UI thread. 0 means one per online CPU.
+  size_t SamplingThreads = 0;
+  // Redraw as soon as the system stalls for PressureTriggerStall within PressureTriggerWindow, instead of waiting for
+  // the next refresh. Unprivileged users may only use windows in multiples of 2s.
+  bool UsePressureTriggers = true;
+  std::chrono::microseconds PressureTriggerStall = std::chrono::milliseconds(100);
+  std::chrono::microseconds PressureTriggerWindow = std::chrono::seconds(2);
 };
 
 } // namespace frontend::curses
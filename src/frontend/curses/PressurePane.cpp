@@ -0,0 +1,86 @@
+#include "PressurePane.hpp"
+
+#include <format>
+
+#include "OmniMon.hpp"
+#include "Options.hpp"
+
+namespace frontend::curses {
+
+using backend::system::Pressure;
+
+void PressureTriggerHandle::OnRead() {
+  // This should never happen.
+  throw std::runtime_error("PressureTriggerHandle::OnRead");
+}
+
+void PressureTriggerHandle::OnWrite() {
+  // This should never happen.
+  throw std::runtime_error("PressureTriggerHandle::OnWrite");
+}
+
+void PressureTriggerHandle::OnPriority() {
+  _Pane.OnTrigger(*_Pressure);
+  SchedulePriority();
+}
+
+PressurePane::PressurePane(EventLoop& loop) : _View(std::make_shared<TextView>(TextView::Align::Left)) {
+  auto config = Config::GetInstance();
+  // In hundredths of a percent, like the averages.
+  _StallThreshold = config.PressureTriggerStall * 10000 / config.PressureTriggerWindow;
+  for (size_t i = 0; i < ResourceCount; ++i) {
+    try {
+      _Pressure[i] = std::make_shared<Pressure>(static_cast<Pressure::Resource>(i));
+    } catch (const std::system_error&) {
+      // No PSI in this kernel, or not for this resource.
+      continue;
+    }
+
+    _Averages[i] = Pressure::GetGauge(_Pressure[i], Pressure::Kind::Some, Pressure::Field::Avg10);
+
+    if (config.UsePressureTriggers) {
+      // Failing here is not fatal, the pane is still refreshed with the screen.
+      if (int fd = _Pressure[i]->OpenTrigger(Pressure::Kind::Some, config.PressureTriggerStall,
+                                             config.PressureTriggerWindow);
+          fd >= 0) {
+        _Triggers.push_back(std::make_unique<PressureTriggerHandle>(loop, fd, *this, _Pressure[i]));
+      }
+    }
+  }
+  UpdateText();
+}
+
+void PressurePane::Update() {
+  for (auto& pressure : _Pressure) {
+    if (pressure) {
+      pressure->Update();
+    }
+  }
+  if (_Stalled && _Averages[static_cast<size_t>(*_Stalled)]->GetValue() < _StallThreshold) {
+    _Stalled.reset();
+  }
+  UpdateText();
+}
+
+void PressurePane::OnTrigger(Pressure& pressure) {
+  _Stalled = pressure.GetResource();
+  pressure.Update();
+  UpdateText();
+  OmniMon::GetInstance().ScheduleDraw();
+}
+
+void PressurePane::UpdateText() {
+  static constexpr std::array<const char*, ResourceCount> names{"cpu", "mem", "io"};
+
+  std::string text;
+  for (size_t i = 0; i < ResourceCount; ++i) {
+    if (!_Averages[i]) {
+      continue;
+    }
+    bool stalled = _Stalled && static_cast<size_t>(*_Stalled) == i;
+    text += std::format("{} {:.2f}%{}  ", names[i], _Averages[i]->GetValue() / 100.0f, stalled ? "!" : " ");
+  }
+  _View->SetText(text.empty() ? text : "PSI  " + text);
+}
+
+} // namespace frontend::curses
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <memory>
+#include <vector>
+
+#include "../../backend/system/Pressure.hpp"
+#include "Events.hpp"
+#include "layouts/TextView.hpp"
+
+namespace frontend::curses {
+
+class PressurePane;
+
+// One PSI trigger. The kernel signals it at most once per window.
+class PressureTriggerHandle : public EventHandle {
+public:
+  explicit PressureTriggerHandle(EventLoop& loop, int fd, PressurePane& pane,
+                                 std::shared_ptr<backend::system::Pressure> pressure)
+      : EventHandle(loop, fd), _Pane(pane), _Pressure(pressure) {
+    SchedulePriority();
+  }
+  ~PressureTriggerHandle() override = default;
+
+  void OnRead() override;
+  void OnWrite() override;
+  void OnPriority() override;
+
+private:
+  PressurePane& _Pane;
+  std::shared_ptr<backend::system::Pressure> _Pressure;
+};
+
+// A line with the system wide pressure stall information: the share of time some task waited on each resource.
+class PressurePane {
+public:
+  explicit PressurePane(EventLoop& loop);
+
+  std::shared_ptr<View> GetView() const { return _View; }
+  void Update();
+  void OnTrigger(backend::system::Pressure& pressure);
+
+private:
+  static constexpr size_t ResourceCount = static_cast<size_t>(backend::system::Pressure::Resource::Count);
+
+  void UpdateText();
+
+  std::shared_ptr<TextView> _View;
+  std::array<std::shared_ptr<backend::system::Pressure>, ResourceCount> _Pressure;
+  std::array<std::shared_ptr<backend::metrics::Gauge>, ResourceCount> _Averages;
+  std::vector<std::unique_ptr<PressureTriggerHandle>> _Triggers;
+  // The resource whose trigger fired last, marked until the stall is over: until its avg10 falls below the share of
+  // the window the trigger asks for.
+  std::optional<backend::system::Pressure::Resource> _Stalled;
+  backend::metrics::DataType _StallThreshold = 0;
+};
+
+} // namespace frontend::curses
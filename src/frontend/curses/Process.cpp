@@ -2,7 +2,7 @@
 
 namespace frontend::curses {
 
-Process::Process(const std::filesystem::path& dir) : backend::process::Process(dir) {}
+Process::Process(int dirFd, std::string_view name) : backend::process::Process(dirFd, name) {}
 
 Process::~Process() {
   if (_Parent) {
@@ -10,9 +10,14 @@ namespace frontend::curses {
 
 class Process : public backend::process::Process {
 public:
-  explicit Process(const std::filesystem::path& dir);
+  explicit Process(int dirFd, std::string_view name);
   ~Process();
 
+  // Threads are shown as children of their process. The leader thread is the process row itself.
+  bool IsThread() const { return _Tgid != 0; }
+  backend::process::PidType GetTgid() const { return _Tgid; }
+  void SetTgid(backend::process::PidType tgid) { _Tgid = tgid; }
+
   std::shared_ptr<Process> GetParent() const { return _Parent; }
   void SetParent(std::shared_ptr<Process> parent) { _Parent = parent; }
   void AddChild(std::shared_ptr<Process> child) { _Children[child->GetPid()] = child; }
@@ -30,6 +35,7 @@ private:
     }
   };
 
+  backend::process::PidType _Tgid = 0;
   std::shared_ptr<Process> _Parent;
   std::map<backend::process::PidType, std::weak_ptr<Process>> _Children;
 };
@@ -1,22 +1,100 @@
 #include "ProcessOrder.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <charconv>
+#include <format>
 #include <functional>
 #include <ranges>
 #include <span>
+#include <stdexcept>
 
+#include "../../backend/process/task/TaskIter.hpp"
+#include "../../utils/Error.hpp"
+#include "../../utils/Pool.hpp"
+#include "OmniMon.hpp"
+#include "Options.hpp"
 #include "Process.hpp"
 
 namespace frontend::curses {
 
-class ProcessOrderTree {
-public:
-  bool operator()(std::shared_ptr<Process> a, std::shared_ptr<Process> b) const {
-    return std::ranges::lexicographical_compare(Process::GetAncestors(a), Process::GetAncestors(b),
-                                                [](auto& a, auto& b) { return a->GetPid() < b->GetPid(); });
+void ProcessEventHandle::OnRead() {
+  _Events.Receive(_Fd);
+  ScheduleRead();
+}
+
+void ProcessEventHandle::OnWrite() {
+  // This should never happen.
+  throw std::runtime_error("ProcessEventHandle::OnWrite");
+}
+
+void TaskstatsQueryHandle::OnRead() {
+  _Collection.OnTaskstatsReply(_Fd);
+  ScheduleRead();
+}
+
+void TaskstatsQueryHandle::OnWrite() {
+  // This should never happen.
+  throw std::runtime_error("TaskstatsQueryHandle::OnWrite");
+}
+
+void TaskstatsExitHandle::OnRead() {
+  _Collection.OnTaskstatsExit(_Fd);
+  ScheduleRead();
+}
+
+void TaskstatsExitHandle::OnWrite() {
+  // This should never happen.
+  throw std::runtime_error("TaskstatsExitHandle::OnWrite");
+}
+
+ProcessCollection::ProcessCollection(EventLoop& loop)
+    : _Listing(*this), _Events(_Listing, *this),
+      _Planner(Config::GetInstance().SlowSamplingInterval / Config::GetInstance().RefreshInterval) {
+  if (Config::GetInstance().UseProcConnector) {
+    if (int fd = backend::process::ProcessEvents::Open(); fd >= 0) {
+      _EventHandle = std::make_unique<ProcessEventHandle>(loop, fd, _Events);
+    }
+  }
+
+  if (Config::GetInstance().UseBpfTaskIterator) {
+    try {
+      _TaskIter = std::make_unique<backend::process::task::TaskIter>(backend::bpf::BpfManager::GetInstance());
+    } catch (const std::runtime_error& e) {
+      // Not privileged or the kernel lacks task iterators, fall back to /proc.
+    }
+  }
+
+  if (!_TaskIter && Config::GetInstance().UseIoUring) {
+    try {
+      _Uring = std::make_unique<backend::process::UringReader>(UringBatch * 2);
+    } catch (const std::system_error& e) {
+      // No io_uring, fall back to pread from the worker pool.
+    }
+  }
+
+  if (!_TaskIter && !_Uring) {
+    _SamplingPool = std::make_unique<utils::WorkerPool>(Config::GetInstance().SamplingThreads);
   }
-};
+
+  if (Config::GetInstance().UseTaskstats) {
+    try {
+      _Taskstats = std::make_unique<backend::process::Taskstats>();
+      _TaskstatsQueryHandle =
+          std::make_unique<TaskstatsQueryHandle>(loop, PosixE(_Taskstats->OpenQuerySocket()), *_Taskstats, *this);
+      if (int fd = _Taskstats->OpenExitListener(); fd >= 0) {
+        _TaskstatsExitHandle = std::make_unique<TaskstatsExitHandle>(loop, fd, *this);
+      }
+    } catch (const std::system_error& e) {
+      // Not privileged or the kernel lacks taskstats.
+      _TaskstatsQueryHandle.reset();
+      _Taskstats.reset();
+    }
+  }
+}
+
+ProcessCollection::~ProcessCollection() = default;
 
 std::shared_ptr<Process> ProcessCollection::GetProcess(backend::process::PidType pid) const {
   auto it = _ProcessCache.find(pid);
@@ -28,57 +106,358 @@ std::shared_ptr<Process> ProcessCollection::GetProcess(backend::process::PidType
 }
 
 void ProcessCollection::UpdateList() {
-  _Listing.DoIterate();
+  UpdateThreads();
 
-  for (auto& [_, proc] : _ProcessCache) {
-    proc->Update();
+  if (_TaskIter) {
+    UpdateFromTaskIter();
+  } else {
+    _Listed.clear();
+    _Scanning = true;
+    if (_EventHandle) {
+      _Scanned = _Events.DoIterate();
+    } else {
+      _Listing.DoIterate();
+      _Scanned = true;
+    }
+    _Scanning = false;
+    UpdateFromProc();
   }
 
   std::erase_if(_ProcessCache, [](auto& proc) { return !proc.second->Exists(); });
+  std::erase_if(_Expanded, [this](auto& expanded) { return !_ProcessCache.contains(expanded.first); });
+
+  if (_Taskstats) {
+    UpdateAccounting();
+  }
 
   for (auto& [_, proc] : _ProcessCache) {
-    auto parent = GetProcess(proc->GetPPid());
+    auto parent = GetProcess(proc->IsThread() ? proc->GetTgid() : proc->GetPPid());
     proc->SetParent(parent);
     if (parent) {
       parent->AddChild(proc);
     }
   }
+  _SnapshotStale = true;
+}
+
+void ProcessCollection::Expand(backend::process::PidType pid) {
+  if (_Expanded.contains(pid)) {
+    return;
+  }
+
+  try {
+    auto& listing = _Expanded[pid] = std::make_unique<ThreadListing>(*this, pid);
+    listing->DoIterate();
+  } catch (const std::system_error& e) {
+    // The process is gone.
+    _Expanded.erase(pid);
+  }
+}
+
+void ProcessCollection::Collapse(backend::process::PidType pid) {
+  if (_Expanded.erase(pid) > 0) {
+    std::erase_if(_ProcessCache, [pid](auto& proc) { return proc.second->GetTgid() == pid; });
+    _SnapshotStale = true;
+  }
+}
+
+void ProcessCollection::OnThread(backend::process::PidType pid, backend::process::PidType tid) {
+  _ListedThreads.insert(tid);
+  if (tid == pid) {
+    return;
+  }
+
+  auto& v = _ProcessCache[tid];
+  if (!v) {
+    v = utils::MakePooled<Process>(_Listing.GetProcFd(), std::format("{}/task/{}", pid, tid));
+    v->SetTgid(pid);
+    v->Update();
+    if (auto parent = GetProcess(pid)) {
+      v->SetParent(parent);
+      parent->AddChild(v);
+    }
+    _SnapshotStale = true;
+  }
+}
+
+void ProcessCollection::UpdateThreads() {
+  // Threads are only listed for expanded processes, so collapsed ones cost nothing.
+  _ListedThreads.clear();
+  for (auto it = _Expanded.begin(); it != _Expanded.end();) {
+    try {
+      it->second->DoIterate();
+      ++it;
+    } catch (const std::system_error& e) {
+      // The process is gone, its threads are dropped with it.
+      it = _Expanded.erase(it);
+    }
+  }
+}
+
+void ProcessCollection::UpdateFromProc() {
+  // Reading /proc dominates the refresh, so spread it over the pool. Gauges notify their subscribers, which are not
+  // thread-safe, so publishing stays on this thread.
+  _SamplingBatch.clear();
+  _Planner.BeginRound();
+  for (auto& [pid, proc] : _ProcessCache) {
+    // Processes which may be gone are read right away, so existence is as fresh as in the fast tier. That includes
+    // exits lost in a connector overflow, which the rescan after it doesn't list.
+    bool forced = proc->IsThread() ? !_ListedThreads.contains(pid)
+                                   : _ExitPending.contains(pid) || (_Scanned && !_Listed.contains(pid));
+    if (_Planner.IsDue(*proc, forced)) {
+      _SamplingBatch.push_back(proc.get());
+    }
+  }
+  _Planner.EndRound();
+
+  if (_Uring) {
+    UpdateFromUring();
+  } else {
+    _SamplingPool->Run(_SamplingBatch.size(), [this](size_t i) { _SamplingBatch[i]->Sample(); });
+  }
+
+  _Exited.clear();
+  for (auto* proc : _SamplingBatch) {
+    proc->Publish();
+    if (proc->IsRecycled()) {
+      _Recycled.push_back(proc->GetPid());
+    } else if (!proc->Exists()) {
+      _Exited.insert(proc->GetPid());
+    }
+  }
+  ReplaceRecycled();
+  std::erase_if(_ExitPending, [this](auto pid) {
+    auto proc = GetProcess(pid);
+    return !proc || !proc->Exists();
+  });
+
+  // Children of exited processes are reparented; read them now, or the slow tier would keep them under a parent
+  // which is gone.
+  if (!_Exited.empty()) {
+    for (auto& [_, proc] : _ProcessCache) {
+      if (proc->Exists() && _Exited.contains(proc->GetPPid())) {
+        proc->Update();
+      }
+    }
+  }
+}
+
+void ProcessCollection::UpdateFromUring() {
+  // Every process of a batch keeps its descriptors pinned until the batch completes, so a batch must stay well below
+  // the descriptor budget.
+  _BatchReads.resize(UringBatch * 2);
+  _BatchBuffers.resize(UringBatch);
+
+  for (size_t offset = 0; offset < _SamplingBatch.size(); offset += UringBatch) {
+    auto batch = std::span(_SamplingBatch).subspan(offset, std::min(UringBatch, _SamplingBatch.size() - offset));
+    for (size_t i = 0; i < batch.size(); ++i) {
+      batch[i]->PrepareSample(std::span(_BatchReads).subspan(i * 2).first<2>(), _BatchBuffers[i]);
+    }
+
+    _Uring->Read(std::span(_BatchReads).first(batch.size() * 2));
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+      batch[i]->CompleteSample(std::span<const backend::process::BatchRead>(_BatchReads).subspan(i * 2).first<2>());
+    }
+  }
+}
+
+void ProcessCollection::UpdateFromTaskIter() {
+  _TaskIter->Read(_TaskSamples);
+
+  for (auto& [pid, sample] : _TaskSamples) {
+    auto& proc = _ProcessCache[pid];
+    if (!proc) {
+      std::array<char, 16> name;
+      auto [end, ec] = std::to_chars(name.data(), name.data() + name.size() - 1, pid);
+      *end = '\0';
+      proc = utils::MakePooled<Process>(_Listing.GetProcFd(), std::string_view(name.data(), end - name.data()));
+    }
+    proc->Update(sample);
+    if (proc->IsRecycled()) {
+      _Recycled.push_back(pid);
+    }
+  }
+
+  // The iterator didn't see these, so they are most likely gone. Let /proc confirm it.
+  for (auto& [pid, proc] : _ProcessCache) {
+    if (!_TaskSamples.contains(pid)) {
+      proc->Update();
+      if (proc->IsRecycled()) {
+        _Recycled.push_back(pid);
+      }
+    }
+  }
+  ReplaceRecycled();
+}
+
+void ProcessCollection::ReplaceRecycled() {
+  // The old object keeps its gauges; rows showing it rebind to the new one on the next refresh and drop them.
+  for (auto pid : _Recycled) {
+    auto it = _ProcessCache.find(pid);
+    if (it == _ProcessCache.end()) {
+      continue;
+    }
+    if (it->second->IsThread()) {
+      // OnThread adds it again if the tid still belongs to an expanded process.
+      _ProcessCache.erase(it);
+      continue;
+    }
+
+    // Whatever is known about the pid belongs to the old process.
+    Collapse(pid);
+    _ExitPending.erase(pid);
+    auto& proc = _ProcessCache[pid];
+    proc = utils::MakePooled<Process>(_Listing.GetProcFd(), std::format("{}", pid));
+    proc->Update();
+  }
+  _Recycled.clear();
+}
+
+void ProcessCollection::UpdateAccounting() {
+  _AccountingPids.clear();
+  for (auto& [pid, proc] : _ProcessCache) {
+    if (proc->WantsAccounting()) {
+      _AccountingPids.push_back(pid);
+    }
+  }
+
+  _TaskstatsQueryHandle->Query(_AccountingPids);
+}
+
+void ProcessCollection::OnTaskstatsReply(int fd) {
+  _Accounting.clear();
+  _Taskstats->ReceiveReplies(fd, _Accounting);
+  ApplyAccounting();
+  if (!_Accounting.empty()) {
+    OmniMon::GetInstance().ScheduleDraw();
+  }
+}
+
+void ProcessCollection::OnTaskstatsExit(int fd) {
+  _Accounting.clear();
+  _Taskstats->ReceiveExits(fd, _Accounting);
+  ApplyAccounting();
+}
+
+void ProcessCollection::ApplyAccounting() {
+  for (auto& accounting : _Accounting) {
+    if (auto proc = GetProcess(accounting.tgid)) {
+      proc->Update(accounting);
+    }
+  }
 }
 
-void ProcessCollection::operator()(backend::process::PidType pid, const std::filesystem::path& dir) {
+void ProcessCollection::operator()(backend::process::PidType pid, int dirFd, std::string_view name) {
+  if (_Scanning) {
+    _Listed.insert(pid);
+  }
+
   auto& v = _ProcessCache[pid];
   if (!v) {
-    v = std::make_shared<Process>(dir);
+    v = utils::MakePooled<Process>(dirFd, name);
+    // Processes reported by events arrive between refreshes and must be orderable right away. Those found by a scan
+    // are sampled by UpdateFromProc in the same refresh.
+    if (!_Scanning) {
+      v->Update();
+    }
+    _SnapshotStale = true;
   }
 }
 
+void ProcessCollection::OnExit(backend::process::PidType pid) {
+  if (_ProcessCache.contains(pid)) {
+    _ExitPending.insert(pid);
+  }
+}
+
+void ProcessCollection::OnExec(backend::process::PidType pid) {
+  if (auto it = _ProcessCache.find(pid); it != _ProcessCache.end()) {
+    it->second->InvalidateCommandLine();
+  }
+}
+
+void ProcessCollection::UpdateSnapshot() {
+  if (!_SnapshotStale) {
+    return;
+  }
+
+  // Parents as drawn, i.e. as of the last UpdateList, not as reported since.
+  _Snapshot.Clear();
+  _SnapshotProcesses.clear();
+  for (auto& [pid, proc] : _ProcessCache) {
+    auto parent = proc->GetParent();
+    _Snapshot.Add(pid, parent ? parent->GetPid() : 0, proc->GetValues());
+    _SnapshotProcesses.push_back(proc);
+  }
+  _Snapshot.Finish();
+  _SnapshotStale = false;
+  _OrderStale = true;
+}
+
+namespace {
+
+backend::process::ProcessSnapshot::Column GetSortColumn(ProcessCollection::Order order) {
+  using Column = backend::process::ProcessSnapshot::Column;
+  return order == ProcessCollection::Order::Cpu ? Column::Cpu : Column::Rss;
+}
+
+} // namespace
+
+void ProcessCollection::SetOrder(Order order) {
+  _Order = order;
+  _OrderStale = true;
+}
+
+void ProcessCollection::UpdateOrder() {
+  UpdateSnapshot();
+  if (!_OrderStale) {
+    return;
+  }
+
+  if (_Order == Order::Tree) {
+    auto tree = _Snapshot.GetTreeOrder();
+    _Ordered.assign(tree.begin(), tree.end());
+  } else {
+    _Snapshot.Sort(GetSortColumn(_Order), _Ordered);
+  }
+  _OrderedPositions.resize(_Ordered.size());
+  for (size_t i = 0; i < _Ordered.size(); ++i) {
+    _OrderedPositions[_Ordered[i]] = i;
+  }
+  _OrderStale = false;
+}
+
 std::shared_ptr<Process> ProcessCollection::MoveCursor(std::shared_ptr<Process> current, DisplayLength offset) {
   // Move the cursor to the process at the given offset. Return the process at the offset.
   // If the offset is out of bounds, return the first or last process.
-  if (offset == 0) {
+  UpdateOrder();
+  auto slot = _Snapshot.Find(current->GetPid());
+  if (slot == backend::process::ProcessSnapshot::NoSlot) {
     return current;
-  } else if (offset > 0) {
-    std::vector<std::shared_ptr<Process>> result(offset + 1);
-    // The std::ranges::partial_sort_copy() call below copies first `offset` number of processes that are after current
-    // process into the result vector, including current. The processes are sorted in normal order.
-    auto [_, end] = std::ranges::partial_sort_copy(_ProcessCache | std::views::values | std::views::filter([&](auto p) {
-                                                     return !ProcessOrderTree()(p, current);
-                                                   }),
-                                                   result, ProcessOrderTree());
-    return end == result.begin() ? current : *--end;
-  } else {
-    std::vector<std::shared_ptr<Process>> result(-offset);
-    auto [_, end] = std::ranges::partial_sort_copy(
-        _ProcessCache | std::views::values | std::views::filter([&](auto p) { return ProcessOrderTree()(p, current); }),
-        result, std::not_fn(ProcessOrderTree()));
-    return end == result.begin() ? current : *--end;
   }
+
+  DisplayLength position = static_cast<DisplayLength>(_OrderedPositions[slot]) + offset;
+  position = std::clamp(position, 0, static_cast<DisplayLength>(_Ordered.size()) - 1);
+  return _SnapshotProcesses[_Ordered[position]];
 }
 
 std::vector<std::shared_ptr<Process>> ProcessCollection::GetTopK(size_t k) {
-  std::vector<std::shared_ptr<Process>> result(k);
-  auto [_, end] = std::ranges::partial_sort_copy(_ProcessCache | std::views::values, result, ProcessOrderTree());
-  return {result.begin(), end};
+  UpdateSnapshot();
+  std::vector<backend::process::ProcessSnapshot::Slot> slots;
+  if (_Order == Order::Tree) {
+    auto tree = _Snapshot.GetTreeOrder();
+    slots.assign(tree.begin(), tree.begin() + std::min(k, tree.size()));
+  } else {
+    _Snapshot.TopK(GetSortColumn(_Order), k, slots);
+  }
+
+  std::vector<std::shared_ptr<Process>> result;
+  result.reserve(slots.size());
+  for (auto slot : slots) {
+    result.push_back(_SnapshotProcesses[slot]);
+  }
+  return result;
 }
 
 std::vector<std::shared_ptr<Process>>
@@ -95,58 +474,31 @@ ProcessCollection::GetAround(std::shared_ptr<Process> process, DisplayLength& cu
     }
   }();
 
-  if (_ProcessCache.size() <= max) {
-    auto range = _ProcessCache | std::views::values;
-    std::vector<std::shared_ptr<Process>> result(range.begin(), range.end());
-    std::ranges::sort(result, ProcessOrderTree());
-    auto it = std::lower_bound(result.begin(), result.end(), at, ProcessOrderTree());
-    assert(it != result.end());
-    cursor = it - result.begin();
-    return result;
-  } else {
-    // Count how many processes are before and after the selected process.
-    // The selected process itself is not counted.
-    DisplayLength countBefore =
-        std::ranges::count_if(_ProcessCache, [&](auto& p) { return ProcessOrderTree()(p.second, at); });
-    DisplayLength countAfter = _ProcessCache.size() - countBefore - 1;
-
-    // The countBefore and countAfter variables are now the number of processes before and after the selected process,
-    // but they might be too large, because the cursor might be at the beginning or end of the list.
-    // The std::min() calls below ensure that the counts never exceed the maximum number of processes that can be
-    // displayed.
-    auto before = std::min(countBefore, std::max(cursor, max - countAfter - 1));
-    auto after = std::min(countAfter, std::max(max - cursor - 1, max - countBefore - 1));
-    cursor = before;
-
-    // The result vector will contain the processes that will be displayed, including the selected process.
-    // We need to allocate space for the maximum number of processes that can be displayed,
-    // because otherwise the std::ranges::partial_sort_copy() call below will not work.
-    std::vector<std::shared_ptr<Process>> result(before + 1 + after);
-
-    // At this point the result vector is full of default-constructed shared_ptr<Process> objects.
-    // We now need to fill the result vector with the processes that will be displayed.
-    // We do this in two steps:
-    // 1. We copy the processes that are before the selected process into the beginning of the result vector.
-    // 2. We copy the processes that are after the selected process into the end of the result vector.
-    // The processes that are before the selected process are copied in reverse order,
-    // because the std::ranges::partial_sort_copy() call below sorts the processes in reverse order.
-    // The processes that are after the selected process are sorted in normal order,
-    // because the std::ranges::partial_sort_copy() call below sorts the processes in normal order.
-
-    // Copy the processes that are before the selected process into the beginning of the result vector.
-    std::ranges::partial_sort_copy(
-        _ProcessCache | std::views::values | std::views::filter([&](auto p) { return ProcessOrderTree()(p, at); }),
-        std::span(result.begin(), result.begin() + before) | std::views::reverse, std::not_fn(ProcessOrderTree()));
-
-    // Copy the processes that are after the selected process into the end of the result vector.
-    std::ranges::partial_sort_copy(_ProcessCache | std::views::values |
-                                       std::views::filter([&](auto p) { return !ProcessOrderTree()(p, at); }),
-                                   std::span(result.begin() + before, result.end()), ProcessOrderTree());
-
-    return result;
+  UpdateOrder();
+  std::span<const backend::process::ProcessSnapshot::Slot> order = _Ordered;
+  auto slot = _Snapshot.Find(at->GetPid());
+  assert(slot != backend::process::ProcessSnapshot::NoSlot);
+  DisplayLength position = 0;
+  if (slot != backend::process::ProcessSnapshot::NoSlot) {
+    position = static_cast<DisplayLength>(_OrderedPositions[slot]);
   }
 
+  // Count how many processes are before and after the selected process.
+  // The selected process itself is not counted.
+  DisplayLength countBefore = position;
+  DisplayLength countAfter = static_cast<DisplayLength>(order.size()) - position - 1;
+
+  // The counts might be too large, because the cursor might be at the beginning or end of the list. The std::min()
+  // calls below ensure that the counts never exceed the maximum number of processes that can be displayed.
+  auto before = std::min(countBefore, std::max(cursor, max - countAfter - 1));
+  auto after = std::min(countAfter, std::max(max - cursor - 1, max - countBefore - 1));
+  cursor = before;
+
   std::vector<std::shared_ptr<Process>> result;
+  result.reserve(before + 1 + after);
+  for (auto slot : order.subspan(position - before, before + 1 + after)) {
+    result.push_back(_SnapshotProcesses[slot]);
+  }
   return result;
 }
 
@@ -3,35 +3,190 @@
 #include <list>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "../../backend/process/Process.hpp"
+#include "../../backend/process/ProcessEvents.hpp"
 #include "../../backend/process/ProcessListing.hpp"
+#include "../../backend/process/ProcessSnapshot.hpp"
+#include "../../backend/process/SamplingPlanner.hpp"
+#include "../../backend/process/TaskSample.hpp"
+#include "../../backend/process/Taskstats.hpp"
+#include "../../backend/process/UringReader.hpp"
 #include "../../utils/StringUtils.hpp"
+#include "../../utils/WorkerPool.hpp"
+#include "Events.hpp"
+
+namespace backend::process::task {
+class TaskIter;
+}
 
 namespace frontend::curses {
 
 class Process;
 
+class ProcessEventHandle : public EventHandle {
+public:
+  explicit ProcessEventHandle(EventLoop& loop, int fd, backend::process::ProcessEvents& events)
+      : EventHandle(loop, fd), _Events(events) {
+    ScheduleRead();
+  }
+  ~ProcessEventHandle() override = default;
+
+  void OnRead() override;
+  void OnWrite() override;
+
+private:
+  backend::process::ProcessEvents& _Events;
+};
+
+class ProcessCollection;
+
+class TaskstatsExitHandle : public EventHandle {
+public:
+  explicit TaskstatsExitHandle(EventLoop& loop, int fd, ProcessCollection& collection)
+      : EventHandle(loop, fd), _Collection(collection) {
+    ScheduleRead();
+  }
+  ~TaskstatsExitHandle() override = default;
+
+  void OnRead() override;
+  void OnWrite() override;
+
+private:
+  ProcessCollection& _Collection;
+};
+
+// The socket taskstats queries are sent on; replies are applied as they arrive.
+class TaskstatsQueryHandle : public EventHandle {
+public:
+  explicit TaskstatsQueryHandle(EventLoop& loop, int fd, backend::process::Taskstats& taskstats,
+                                ProcessCollection& collection)
+      : EventHandle(loop, fd), _Taskstats(taskstats), _Collection(collection) {
+    ScheduleRead();
+  }
+  ~TaskstatsQueryHandle() override = default;
+
+  void Query(std::span<const backend::process::PidType> tgids) { _Taskstats.Query(_Fd, tgids); }
+
+  void OnRead() override;
+  void OnWrite() override;
+
+private:
+  backend::process::Taskstats& _Taskstats;
+  ProcessCollection& _Collection;
+};
+
 class ProcessCollection : public backend::process::ProcessListingCallback {
 public:
-  explicit ProcessCollection() : _Listing(*this) {}
-  ~ProcessCollection() = default;
+  explicit ProcessCollection(EventLoop& loop);
+  ~ProcessCollection();
 
   std::shared_ptr<Process> GetProcess(backend::process::PidType pid) const;
 
   void UpdateList();
 
+  // How the rows are ordered: as a tree, or flat by a column of the snapshot, largest first.
+  enum class Order { Tree, Cpu, Rss, Count };
+  Order GetOrder() const { return _Order; }
+  void SetOrder(Order order);
+
   std::shared_ptr<Process> MoveCursor(std::shared_ptr<Process> current, DisplayLength offset);
 
   std::vector<std::shared_ptr<Process>> GetTopK(size_t k);
   std::vector<std::shared_ptr<Process>> GetAround(std::shared_ptr<Process> process, DisplayLength& cursor,
                                                   DisplayLength max, bool update);
 
-  void operator()(backend::process::PidType pid, const std::filesystem::path& dir) override;
+  // Threads of expanded processes are kept next to the processes, as their children.
+  void Expand(backend::process::PidType pid);
+  void Collapse(backend::process::PidType pid);
+  bool IsExpanded(backend::process::PidType pid) const { return _Expanded.contains(pid); }
+
+  void operator()(backend::process::PidType pid, int dirFd, std::string_view name) override;
+  void OnExit(backend::process::PidType pid) override;
+  void OnExec(backend::process::PidType pid) override;
+  void OnTaskstatsReply(int fd);
+  void OnTaskstatsExit(int fd);
+
+  const backend::process::SamplingPlanner& GetPlanner() const { return _Planner; }
 
 private:
+  // Processes sampled per io_uring submission, two reads each.
+  static constexpr size_t UringBatch = 128;
+
+  class ThreadListing : public backend::process::ProcessListingCallback {
+  public:
+    explicit ThreadListing(ProcessCollection& collection, backend::process::PidType pid)
+        : _Collection(collection), _Pid(pid), _Listing(*this, collection._Listing.GetProcFd(), pid) {}
+    ~ThreadListing() override = default;
+
+    void DoIterate() { _Listing.DoIterate(); }
+    void operator()(backend::process::PidType tid, int dirFd, std::string_view name) override {
+      _Collection.OnThread(_Pid, tid);
+    }
+
+  private:
+    ProcessCollection& _Collection;
+    const backend::process::PidType _Pid;
+    backend::process::ProcessListing _Listing;
+  };
+
+  void OnThread(backend::process::PidType pid, backend::process::PidType tid);
+  void UpdateThreads();
+  void UpdateFromProc();
+  void UpdateFromUring();
+  void UpdateFromTaskIter();
+  void UpdateAccounting();
+  void ApplyAccounting();
+  void ReplaceRecycled();
+  void UpdateSnapshot();
+  void UpdateOrder();
+
   backend::process::ProcessListing _Listing;
+  backend::process::ProcessEvents _Events;
+  // Null when the proc connector is disabled or not permitted, /proc is rescanned on every update then.
+  std::unique_ptr<ProcessEventHandle> _EventHandle;
+  // Null when BPF is disabled or not available, each process reads its /proc/<pid> files then.
+  std::unique_ptr<backend::process::task::TaskIter> _TaskIter;
+  std::unordered_map<backend::process::PidType, backend::process::TaskSample> _TaskSamples;
+  // Only one of these is created when sampling /proc, i.e. without the task iterator.
+  std::unique_ptr<backend::process::UringReader> _Uring;
+  std::unique_ptr<utils::WorkerPool> _SamplingPool;
+  std::vector<Process*> _SamplingBatch;
+  backend::process::SamplingPlanner _Planner;
+  // Pids seen by the full /proc scan of this refresh, if _Scanned: always without the proc connector, after an
+  // overflow with it.
+  std::unordered_set<backend::process::PidType> _Listed;
+  bool _Scanned = false;
+  // Set while /proc is scanned, as opposed to processes reported by the proc connector.
+  bool _Scanning = false;
+  // Reported exited but not yet confirmed gone, e.g. zombies. Read every refresh until they are.
+  std::unordered_set<backend::process::PidType> _ExitPending;
+  std::unordered_set<backend::process::PidType> _Exited;
+  // Pids taken over by a new process since the last refresh, see Process::IsRecycled.
+  std::vector<backend::process::PidType> _Recycled;
+  std::unordered_map<backend::process::PidType, std::unique_ptr<ThreadListing>> _Expanded;
+  // Tids seen by the last scan of the expanded processes.
+  std::unordered_set<backend::process::PidType> _ListedThreads;
+  std::vector<backend::process::BatchRead> _BatchReads;
+  std::vector<backend::process::Process::SampleBuffers> _BatchBuffers;
+  // Null when taskstats is disabled or not permitted, there are no delay metrics then.
+  std::unique_ptr<backend::process::Taskstats> _Taskstats;
+  std::unique_ptr<TaskstatsQueryHandle> _TaskstatsQueryHandle;
+  std::unique_ptr<TaskstatsExitHandle> _TaskstatsExitHandle;
+  std::vector<backend::process::PidType> _AccountingPids;
+  std::vector<backend::process::TaskAccounting> _Accounting;
   std::unordered_map<backend::process::PidType, std::shared_ptr<Process>> _ProcessCache;
+  // _ProcessCache in tree order, rebuilt by UpdateSnapshot when stale. Slot s of the snapshot is _SnapshotProcesses[s].
+  backend::process::ProcessSnapshot _Snapshot;
+  std::vector<std::shared_ptr<Process>> _SnapshotProcesses;
+  bool _SnapshotStale = true;
+  // The slots of _Snapshot in the order of _Order, and the position of each slot in it. Rebuilt by UpdateOrder, only
+  // when navigating; GetTopK needs no full order.
+  Order _Order = Order::Tree;
+  std::vector<backend::process::ProcessSnapshot::Slot> _Ordered;
+  std::vector<size_t> _OrderedPositions;
+  bool _OrderStale = true;
 };
 
 } // namespace frontend::curses
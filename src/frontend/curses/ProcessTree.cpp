@@ -6,9 +6,11 @@
 
 #include "../../backend/metrics/Arithmetic.hpp"
 #include "../../backend/metrics/Counter.hpp"
+#include "../../backend/metrics/Expression.hpp"
 #include "../../backend/system/SysInfo.hpp"
 #include "../../utils/Clock.hpp"
 #include "../../utils/Formatter.hpp"
+#include "../../utils/Pool.hpp"
 #include "OmniMon.hpp"
 #include "Options.hpp"
 #include "Process.hpp"
@@ -157,13 +159,12 @@ public:
     void BindProcess(ProcessTree& tree, ProcessTree::ProcessTreeTableRowBinding& row,
                      std::shared_ptr<Process> process) override {
       if (process) {
+        namespace expr = backend::metrics::expr;
         _CpuUpdater = backend::metrics::MakeSubscriber(
-            std::make_shared<backend::metrics::Ratio>(
-                std::make_shared<backend::metrics::CounterSlice>(
-                    std::make_shared<backend::metrics::Plus>(Process::GetUserTime(process),
-                                                             Process::GetSystemTime(process)),
-                    Config::GetInstance().RefreshInterval),
-                backend::system::SysInfo::GetInstance()->GetSystemJiffies()),
+            expr::MakeFused(expr::Ratio(
+                expr::Slice(expr::Of(Process::GetUserTime(process)) + expr::Of(Process::GetSystemTime(process)),
+                            Config::GetInstance().RefreshInterval),
+                expr::Of(backend::system::SysInfo::GetInstance()->GetSystemJiffies()))),
             [this](auto metric) { _View->SetText(std::format("{:.{}f}", metric->GetValue() / 100.0f, 1)); });
       } else {
         _CpuUpdater.reset();
@@ -200,8 +201,8 @@ public:
                      std::shared_ptr<Process> process) override {
       if (process) {
         _MemUpdater = backend::metrics::MakeSubscriber(
-            std::make_shared<backend::metrics::Ratio>(Process::GetMem(process),
-                                                      backend::system::SysInfo::GetInstance()->GetTotalMem()),
+            utils::MakePooled<backend::metrics::Ratio>(Process::GetMem(process),
+                                                       backend::system::SysInfo::GetInstance()->GetTotalMem()),
             [this](auto metric) { _View->SetText(std::format("{:.{}f}", metric->GetValue() / 100.0f, 1)); });
       } else {
         _MemUpdater.reset();
@@ -215,6 +216,200 @@ public:
   };
 };
 
+class ProcessColumnFaults : public ProcessColumn {
+public:
+  explicit ProcessColumnFaults(Table& table, Process::StatField field, const char* title)
+      : ProcessColumn(table, Container::ArrangementType::Forward, 5), _Field(field), _Title(title) {}
+  ~ProcessColumnFaults() override = default;
+
+  std::shared_ptr<View> HeaderView() const override {
+    auto cell = std::make_shared<TextView>(TextView::Align::Right);
+    cell->SetText(_Title);
+    return cell;
+  }
+
+  std::shared_ptr<ProcessCell> CreateCell(ProcessColumn& column) override { return std::make_shared<Cell>(_Field); }
+
+  class Cell : public ProcessCell {
+  public:
+    Cell(Process::StatField field) : _Field(field), _View(std::make_shared<TextView>(TextView::Align::Right)) {}
+    ~Cell() override = default;
+
+    std::shared_ptr<View> GetView() const override { return _View; }
+    void BindProcess(ProcessTree& tree, ProcessTree::ProcessTreeTableRowBinding& row,
+                     std::shared_ptr<Process> process) override {
+      if (process) {
+        _FaultsUpdater = backend::metrics::MakeSubscriber(
+            utils::MakePooled<backend::metrics::CounterSlice>(Process::GetStatField(process, _Field),
+                                                              Config::GetInstance().RefreshInterval),
+            [this](auto metric) { _View->SetText(utils::CountToString(metric->GetValue(), 5)); });
+      } else {
+        _FaultsUpdater.reset();
+        _View->SetText("");
+      }
+    }
+
+  private:
+    const Process::StatField _Field;
+    std::shared_ptr<TextView> _View;
+    std::shared_ptr<backend::metrics::SubscriberBase> _FaultsUpdater;
+  };
+
+private:
+  const Process::StatField _Field;
+  const char* _Title;
+};
+
+class ProcessColumnMajorFaults : public ProcessColumnFaults {
+public:
+  explicit ProcessColumnMajorFaults(Table& table)
+      : ProcessColumnFaults(table, Process::StatField::MajorFaults, "MajF") {}
+};
+
+class ProcessColumnMinorFaults : public ProcessColumnFaults {
+public:
+  explicit ProcessColumnMinorFaults(Table& table)
+      : ProcessColumnFaults(table, Process::StatField::MinorFaults, "MinF") {}
+};
+
+class ProcessColumnMemoryField : public ProcessColumn {
+public:
+  explicit ProcessColumnMemoryField(Table& table, Process::MemoryField field, const char* title)
+      : ProcessColumn(table, Container::ArrangementType::Forward, 5), _Field(field), _Title(title) {}
+  ~ProcessColumnMemoryField() override = default;
+
+  std::shared_ptr<View> HeaderView() const override {
+    auto cell = std::make_shared<TextView>(TextView::Align::Right);
+    cell->SetText(_Title);
+    return cell;
+  }
+
+  std::shared_ptr<ProcessCell> CreateCell(ProcessColumn& column) override { return std::make_shared<Cell>(_Field); }
+
+  class Cell : public ProcessCell {
+  public:
+    Cell(Process::MemoryField field) : _Field(field), _View(std::make_shared<TextView>(TextView::Align::Right)) {}
+    ~Cell() override = default;
+
+    std::shared_ptr<View> GetView() const override { return _View; }
+    void BindProcess(ProcessTree& tree, ProcessTree::ProcessTreeTableRowBinding& row,
+                     std::shared_ptr<Process> process) override {
+      if (process) {
+        _MemoryUpdater = backend::metrics::MakeSubscriber(
+            Process::GetMemoryField(process, _Field),
+            [this](auto metric) { _View->SetText(utils::DiskSizeToString(metric->GetValue(), 5)); });
+      } else {
+        _MemoryUpdater.reset();
+        _View->SetText("");
+      }
+    }
+
+  private:
+    const Process::MemoryField _Field;
+    std::shared_ptr<TextView> _View;
+    std::shared_ptr<backend::metrics::SubscriberBase> _MemoryUpdater;
+  };
+
+private:
+  const Process::MemoryField _Field;
+  const char* _Title;
+};
+
+class ProcessColumnPss : public ProcessColumnMemoryField {
+public:
+  explicit ProcessColumnPss(Table& table) : ProcessColumnMemoryField(table, Process::MemoryField::Pss, "PSS") {}
+};
+
+class ProcessColumnUss : public ProcessColumnMemoryField {
+public:
+  explicit ProcessColumnUss(Table& table) : ProcessColumnMemoryField(table, Process::MemoryField::Uss, "USS") {}
+};
+
+class ProcessColumnSwap : public ProcessColumnMemoryField {
+public:
+  explicit ProcessColumnSwap(Table& table) : ProcessColumnMemoryField(table, Process::MemoryField::Swap, "Swap") {}
+};
+
+class ProcessColumnThreads : public ProcessColumn {
+public:
+  explicit ProcessColumnThreads(Table& table) : ProcessColumn(table, Container::ArrangementType::Forward, 3) {}
+  ~ProcessColumnThreads() override = default;
+
+  std::shared_ptr<View> HeaderView() const override {
+    auto cell = std::make_shared<TextView>(TextView::Align::Right);
+    cell->SetText("Thr");
+    return cell;
+  }
+
+  std::shared_ptr<ProcessCell> CreateCell(ProcessColumn& column) override { return std::make_shared<Cell>(column); }
+
+  class Cell : public ProcessCell {
+  public:
+    Cell(ProcessColumn& column) : _Column(column), _View(std::make_shared<TextView>(TextView::Align::Right)) {}
+    ~Cell() override = default;
+
+    std::shared_ptr<View> GetView() const override { return _View; }
+    void BindProcess(ProcessTree& tree, ProcessTree::ProcessTreeTableRowBinding& row,
+                     std::shared_ptr<Process> process) override {
+      if (process) {
+        _ThreadsUpdater = backend::metrics::MakeSubscriber(
+            Process::GetStatField(process, Process::StatField::Threads), [this](auto metric) {
+              auto text = std::format("{}", metric->GetValue());
+              if (_Column.GetSize() < text.size()) {
+                _Column.SetSize(text.size());
+              }
+              _View->SetText(text);
+            });
+      } else {
+        _ThreadsUpdater.reset();
+        _View->SetText("");
+      }
+    }
+
+  private:
+    ProcessColumn& _Column;
+    std::shared_ptr<TextView> _View;
+    std::shared_ptr<backend::metrics::SubscriberBase> _ThreadsUpdater;
+  };
+};
+
+class ProcessColumnVirtualSize : public ProcessColumn {
+public:
+  explicit ProcessColumnVirtualSize(Table& table) : ProcessColumn(table, Container::ArrangementType::Forward, 5) {}
+  ~ProcessColumnVirtualSize() override = default;
+
+  std::shared_ptr<View> HeaderView() const override {
+    auto cell = std::make_shared<TextView>(TextView::Align::Right);
+    cell->SetText("VSZ");
+    return cell;
+  }
+
+  std::shared_ptr<ProcessCell> CreateCell(ProcessColumn& column) override { return std::make_shared<Cell>(); }
+
+  class Cell : public ProcessCell {
+  public:
+    Cell() : _View(std::make_shared<TextView>(TextView::Align::Right)) {}
+    ~Cell() override = default;
+
+    std::shared_ptr<View> GetView() const override { return _View; }
+    void BindProcess(ProcessTree& tree, ProcessTree::ProcessTreeTableRowBinding& row,
+                     std::shared_ptr<Process> process) override {
+      if (process) {
+        _VirtualSizeUpdater = backend::metrics::MakeSubscriber(
+            Process::GetStatField(process, Process::StatField::VirtualSize),
+            [this](auto metric) { _View->SetText(utils::DiskSizeToString(metric->GetValue(), 5)); });
+      } else {
+        _VirtualSizeUpdater.reset();
+        _View->SetText("");
+      }
+    }
+
+  private:
+    std::shared_ptr<TextView> _View;
+    std::shared_ptr<backend::metrics::SubscriberBase> _VirtualSizeUpdater;
+  };
+};
+
 class ProcessColumnTime : public ProcessColumn {
 public:
   explicit ProcessColumnTime(Table& table) : ProcessColumn(table, Container::ArrangementType::Forward, 2) {}
@@ -238,7 +433,7 @@ public:
                      std::shared_ptr<Process> process) override {
       if (process) {
         _TimeUpdater = backend::metrics::MakeSubscriber(
-            std::make_shared<backend::metrics::Plus>(Process::GetUserTime(process), Process::GetSystemTime(process)),
+            utils::MakePooled<backend::metrics::Plus>(Process::GetUserTime(process), Process::GetSystemTime(process)),
             [this](auto metric) {
               auto text = std::format(
                   "{:%H:%M:%S}", std::chrono::floor<std::chrono::seconds>(utils::JiffyToDuration(metric->GetValue())));
@@ -283,8 +478,8 @@ public:
                      std::shared_ptr<Process> process) override {
       if (process) {
         _DiskReadUpdater = backend::metrics::MakeSubscriber(
-            std::make_shared<backend::metrics::CounterSlice>(Process::GetDiskReadBytes(process),
-                                                             Config::GetInstance().RefreshInterval),
+            utils::MakePooled<backend::metrics::CounterSlice>(Process::GetDiskReadBytes(process),
+                                                              Config::GetInstance().RefreshInterval),
             [this](auto metric) { _View->SetText(utils::DiskSizeToString(metric->GetValue(), 5)); });
       } else {
         _DiskReadUpdater.reset();
@@ -321,8 +516,8 @@ public:
                      std::shared_ptr<Process> process) override {
       if (process) {
         _DiskWriteUpdater = backend::metrics::MakeSubscriber(
-            std::make_shared<backend::metrics::CounterSlice>(Process::GetDiskWriteBytes(process),
-                                                             Config::GetInstance().RefreshInterval),
+            utils::MakePooled<backend::metrics::CounterSlice>(Process::GetDiskWriteBytes(process),
+                                                              Config::GetInstance().RefreshInterval),
             [this](auto metric) { _View->SetText(utils::DiskSizeToString(metric->GetValue(), 5)); });
       } else {
         _DiskWriteUpdater.reset();
@@ -359,8 +554,8 @@ public:
                      std::shared_ptr<Process> process) override {
       if (process) {
         _DiskAccumulatedUpdater = backend::metrics::MakeSubscriber(
-            std::make_shared<backend::metrics::Plus>(Process::GetDiskReadBytes(process),
-                                                     Process::GetDiskWriteBytes(process)),
+            utils::MakePooled<backend::metrics::Plus>(Process::GetDiskReadBytes(process),
+                                                      Process::GetDiskWriteBytes(process)),
             [this](auto metric) { _View->SetText(utils::DiskSizeToString(metric->GetValue(), 5)); });
       } else {
         _DiskAccumulatedUpdater.reset();
@@ -396,11 +591,11 @@ public:
     void BindProcess(ProcessTree& tree, ProcessTree::ProcessTreeTableRowBinding& row,
                      std::shared_ptr<Process> process) override {
       if (process) {
+        namespace expr = backend::metrics::expr;
         _IOUpdater = backend::metrics::MakeSubscriber(
-            std::make_shared<backend::metrics::CounterSlice>(
-                std::make_shared<backend::metrics::Plus>(Process::GetReadBytes(process),
-                                                         Process::GetWriteBytes(process)),
-                Config::GetInstance().RefreshInterval),
+            expr::MakeFused(
+                expr::Slice(expr::Of(Process::GetReadBytes(process)) + expr::Of(Process::GetWriteBytes(process)),
+                            Config::GetInstance().RefreshInterval)),
             [this](auto metric) { _View->SetText(utils::DiskSizeToString(metric->GetValue(), 5)); });
       } else {
         _IOUpdater.reset();
@@ -437,7 +632,7 @@ public:
                      std::shared_ptr<Process> process) override {
       if (process) {
         _IOAccumulatedUpdater = backend::metrics::MakeSubscriber(
-            std::make_shared<backend::metrics::Plus>(Process::GetReadBytes(process), Process::GetWriteBytes(process)),
+            utils::MakePooled<backend::metrics::Plus>(Process::GetReadBytes(process), Process::GetWriteBytes(process)),
             [this](auto metric) { _View->SetText(utils::DiskSizeToString(metric->GetValue(), 5)); });
       } else {
         _IOAccumulatedUpdater.reset();
@@ -451,6 +646,76 @@ public:
   };
 };
 
+// Share of the wall time the process spent waiting, from the taskstats delay counters in nanoseconds. Subscribing
+// is what makes ProcessCollection query taskstats for the process; without taskstats the cells stay at 0.0.
+class ProcessColumnDelay : public ProcessColumn {
+public:
+  using Getter = Process::GaugePtr (*)(std::shared_ptr<backend::process::Process>);
+
+  explicit ProcessColumnDelay(Table& table, const char* header, Getter getter)
+      : ProcessColumn(table, Container::ArrangementType::Forward, 5), _Header(header), _Getter(getter) {}
+  ~ProcessColumnDelay() override = default;
+
+  std::shared_ptr<View> HeaderView() const override {
+    auto cell = std::make_shared<TextView>(TextView::Align::Right);
+    cell->SetText(_Header);
+    return cell;
+  }
+
+  std::shared_ptr<ProcessCell> CreateCell(ProcessColumn& column) override { return std::make_shared<Cell>(*this); }
+
+  class Cell : public ProcessCell {
+  public:
+    explicit Cell(ProcessColumnDelay& column)
+        : _Column(column), _View(std::make_shared<TextView>(TextView::Align::Right)) {}
+    ~Cell() override = default;
+
+    std::shared_ptr<View> GetView() const override { return _View; }
+    void BindProcess(ProcessTree& tree, ProcessTree::ProcessTreeTableRowBinding& row,
+                     std::shared_ptr<Process> process) override {
+      if (process) {
+        auto interval = Config::GetInstance().RefreshInterval;
+        _DelayUpdater = backend::metrics::MakeSubscriber(
+            utils::MakePooled<backend::metrics::Ratio>(
+                utils::MakePooled<backend::metrics::CounterSlice>(_Column._Getter(process), interval),
+                std::make_shared<backend::metrics::ConstGauge>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count())),
+            [this](auto metric) { _View->SetText(std::format("{:.{}f}", metric->GetValue() / 100.0f, 1)); });
+      } else {
+        _DelayUpdater.reset();
+        _View->SetText("");
+      }
+    }
+
+  private:
+    ProcessColumnDelay& _Column;
+    std::shared_ptr<TextView> _View;
+    std::shared_ptr<backend::metrics::SubscriberBase> _DelayUpdater;
+  };
+
+private:
+  const char* _Header;
+  const Getter _Getter;
+};
+
+// Waiting for a CPU.
+class ProcessColumnRunDelay : public ProcessColumnDelay {
+public:
+  explicit ProcessColumnRunDelay(Table& table) : ProcessColumnDelay(table, "%RunW", &Process::GetRunDelay) {}
+};
+
+// Waiting for block I/O.
+class ProcessColumnBlkioDelay : public ProcessColumnDelay {
+public:
+  explicit ProcessColumnBlkioDelay(Table& table) : ProcessColumnDelay(table, "%BlkW", &Process::GetBlkioDelay) {}
+};
+
+// Waiting for pages to be swapped in.
+class ProcessColumnSwapinDelay : public ProcessColumnDelay {
+public:
+  explicit ProcessColumnSwapinDelay(Table& table) : ProcessColumnDelay(table, "%SwpW", &Process::GetSwapinDelay) {}
+};
+
 class ProcessColumnStart : public ProcessColumn {
 public:
   explicit ProcessColumnStart(Table& table) : ProcessColumn(table, Container::ArrangementType::Forward, 5) {}
@@ -516,11 +781,19 @@ public:
     std::shared_ptr<View> GetView() const override { return _View; }
     void BindProcess(ProcessTree& tree, ProcessTree::ProcessTreeTableRowBinding& row,
                      std::shared_ptr<Process> process) override {
-      if (process) {
-        _View->SetText(std::format("{}{}", TreeString(process), FormatCommand(process->GetCommandLine())));
-      } else {
+      if (!process) {
+        _OrderUpdater.reset();
         _View->SetText("");
+        return;
       }
+      // The tree lines only mean something while the rows are in tree order.
+      _OrderUpdater = backend::metrics::MakeSubscriber(tree.GetOrder(), [this, process](auto metric) {
+        bool tree = metric->GetValue() == static_cast<backend::metrics::DataType>(ProcessCollection::Order::Tree);
+        // A thread shares the command line of its process, its name tells more.
+        _View->SetText(std::format("{}{}", tree ? TreeString(process) : "",
+                                   FormatCommand(process->IsThread() ? process->GetCommand()
+                                                                     : process->GetCommandLine())));
+      });
     }
 
   private:
@@ -572,23 +845,31 @@ public:
     }
 
     std::shared_ptr<TextView> _View;
+    std::shared_ptr<backend::metrics::SubscriberBase> _OrderUpdater;
   };
 };
 
-ProcessTree::ProcessTree()
-    : _TableInputHandler(std::make_shared<TableInputHandler>(*this)),
+ProcessTree::ProcessTree(EventLoop& loop)
+    : _ProcessCollection(loop), _TableInputHandler(std::make_shared<TableInputHandler>(*this)),
       _Table(
           _TableInputHandler,
-          ColumnBuilder<ProcessColumnCursor, ProcessColumnPid, ProcessColumnState, ProcessColumnMem, ProcessColumnTime,
-                        ProcessColumnDiskRead, ProcessColumnDiskWrite, ProcessColumnDiskAccumulated, ProcessColumnIO,
-                        ProcessColumnIOAccumulated, ProcessColumnStart, ProcessColumnCommand>()),
-      _Cursor(std::make_shared<backend::metrics::SimpleGauge>()) {
+          ColumnBuilder<ProcessColumnCursor, ProcessColumnPid, ProcessColumnState, ProcessColumnMem, ProcessColumnPss,
+                        ProcessColumnUss, ProcessColumnSwap, ProcessColumnVirtualSize, ProcessColumnThreads,
+                        ProcessColumnMajorFaults, ProcessColumnMinorFaults, ProcessColumnTime, ProcessColumnDiskRead,
+                        ProcessColumnDiskWrite, ProcessColumnDiskAccumulated, ProcessColumnIO,
+                        ProcessColumnIOAccumulated, ProcessColumnRunDelay, ProcessColumnBlkioDelay,
+                        ProcessColumnSwapinDelay, ProcessColumnStart, ProcessColumnCommand>()),
+      _Cursor(std::make_shared<backend::metrics::SimpleGauge>()),
+      _Order(std::make_shared<backend::metrics::SimpleGauge>(
+          static_cast<backend::metrics::DataType>(ProcessCollection::Order::Tree))) {
   _Table.AppendRow(std::make_shared<ProcessTreeTableHeaderBinding>());
 }
 
 std::shared_ptr<View> ProcessTree::GetView() const { return _Table.GetTableContainer(); }
 
 void ProcessTree::Update() {
+  UpdateSelection();
+
   std::vector<std::shared_ptr<frontend::curses::Process>> ps;
   if (!_Rows.empty()) {
     DisplayLength index = _Cursor->GetValue();
@@ -602,6 +883,20 @@ void ProcessTree::Update() {
   UpdateTable(ps);
 }
 
+void ProcessTree::UpdateSelection() {
+  // The selected process gets its memory breakdown on every refresh, however expensive.
+  auto selected = _Rows.empty() ? nullptr : _Rows[_Cursor->GetValue()]->GetProcess();
+  if (auto previous = _Selected.lock(); previous != selected) {
+    if (previous) {
+      previous->SetMemoryPriority(false);
+    }
+    if (selected) {
+      selected->SetMemoryPriority(true);
+    }
+    _Selected = selected;
+  }
+}
+
 DisplayLength ProcessTree::GetHeight() const { return _Table.GetTableContainer()->GetLayout().Height - 1; }
 
 void ProcessTree::UpdateTable(const std::vector<std::shared_ptr<frontend::curses::Process>>& ps) {
@@ -650,6 +945,18 @@ bool ProcessTree::OnKey(TermKeyCode key) {
     OmniMon::GetInstance().ScheduleDraw();
     return true;
   }
+  case 's': {
+    // Cycles tree order, by CPU, by RSS; the cursor stays on its process.
+    auto order = static_cast<ProcessCollection::Order>((static_cast<int>(_ProcessCollection.GetOrder()) + 1) %
+                                                       static_cast<int>(ProcessCollection::Order::Count));
+    _ProcessCollection.SetOrder(order);
+    _Order->Update(static_cast<backend::metrics::DataType>(order));
+    if (!_Rows.empty()) {
+      MoveCursorAndDraw(0);
+    }
+    OmniMon::GetInstance().ScheduleDraw();
+    return true;
+  }
   default:
     return _Rows[_Cursor->GetValue()]->OnKey(key);
   }
@@ -663,6 +970,15 @@ void ProcessTree::MoveCursorAndDraw(DisplayLength offset) {
   UpdateTable(ps);
 }
 
+void ProcessTree::ShowThreads(std::shared_ptr<Process> process, bool show) {
+  if (show) {
+    _ProcessCollection.Expand(process->GetPid());
+  } else {
+    _ProcessCollection.Collapse(process->GetPid());
+  }
+  MoveCursorAndDraw(0);
+  OmniMon::GetInstance().ScheduleDraw();
+}
 
 bool ProcessTree::ProcessTreeTableHeaderBinding::OnKey(TermKeyCode key) { return false; }
 
@@ -674,7 +990,22 @@ ProcessTree::ProcessTreeTableRowBinding::ProcessTreeTableRowBinding(ProcessTree&
                                                                     std::shared_ptr<Process> process)
     : _Tree(tree), _Index(index), _Process(process) {}
 
-bool ProcessTree::ProcessTreeTableRowBinding::OnKey(TermKeyCode key) { return false; }
+bool ProcessTree::ProcessTreeTableRowBinding::OnKey(TermKeyCode key) {
+  if (!_Process || _Process->IsThread()) {
+    return false;
+  }
+
+  switch (key) {
+  case '+':
+    _Tree.ShowThreads(_Process, true);
+    return true;
+  case '-':
+    _Tree.ShowThreads(_Process, false);
+    return true;
+  default:
+    return false;
+  }
+}
 
 std::shared_ptr<View> ProcessTree::ProcessTreeTableRowBinding::OnNewCell(Table& table, Row& row, Column& column) {
   auto& c = dynamic_cast<ProcessColumn&>(column);
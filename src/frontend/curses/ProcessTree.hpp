@@ -14,7 +14,7 @@ class ProcessCell;
 
 class ProcessTree {
 public:
-  explicit ProcessTree();
+  explicit ProcessTree(EventLoop& loop);
 
   class ProcessTreeTableHeaderBinding : public TableBinding {
   public:
@@ -63,17 +63,23 @@ public:
   void Update();
   bool OnKey(TermKeyCode key);
   std::shared_ptr<backend::metrics::Gauge> GetCursor() const { return _Cursor; };
+  // The ProcessCollection::Order of the rows.
+  std::shared_ptr<backend::metrics::Gauge> GetOrder() const { return _Order; };
 
 private:
   DisplayLength GetHeight() const;
+  void UpdateSelection();
   void UpdateTable(const std::vector<std::shared_ptr<frontend::curses::Process>>& ps);
   void MoveCursorAndDraw(DisplayLength offset);
+  void ShowThreads(std::shared_ptr<Process> process, bool show);
 
   ProcessCollection _ProcessCollection;
   std::shared_ptr<InputHandler> _TableInputHandler;
   Table _Table;
   std::shared_ptr<backend::metrics::SimpleGauge> _Cursor;
+  std::shared_ptr<backend::metrics::SimpleGauge> _Order;
   std::vector<std::shared_ptr<ProcessTreeTableRowBinding>> _Rows;
+  std::weak_ptr<Process> _Selected;
 };
 
 } // namespace frontend::curses
@@ -6,14 +6,23 @@
 
 namespace frontend::curses {
 
-frontend::curses::Screen::Screen(OmniMon& mon, std::shared_ptr<ProcessTree> ps)
-    : Container(Container::GrowthType::TopDown), _OmniMon(mon) {
-  AppendChild(ps->GetView(), std::make_shared<frontend::curses::Container::SimpleContext>(
-                                 frontend::curses::Container::ArrangementType::FillRest, 1));
+frontend::curses::Screen::Screen(OmniMon& mon, std::shared_ptr<SystemPane> system,
+                                 std::shared_ptr<PressurePane> pressure, std::shared_ptr<ProcessTree> ps,
+                                 std::shared_ptr<CgroupView> cgroups)
+    : Container(Container::GrowthType::TopDown), _OmniMon(mon), _ProcessView(ps->GetView()),
+      _CgroupView(cgroups->GetView()), _CgroupAvailable(cgroups->IsAvailable()) {
+  AppendChild(system->GetView(), std::make_shared<frontend::curses::Container::SimpleContext>(
+                                     frontend::curses::Container::ArrangementType::Forward, SystemPane::Height));
+  AppendChild(pressure->GetView(), std::make_shared<frontend::curses::Container::SimpleContext>(
+                                       frontend::curses::Container::ArrangementType::Forward, 1));
+  AppendChild(_ProcessView, std::make_shared<PageContext>(*this, Page::Processes));
+  AppendChild(_CgroupView, std::make_shared<PageContext>(*this, Page::Cgroups));
+  _CgroupView->SetVisible(false);
 }
 
 bool Screen::OnKey(TermKeyCode key) {
-  if (Container::OnKey(key)) {
+  // Only the page on screen takes keys.
+  if ((_Page == Page::Processes ? _ProcessView : _CgroupView)->OnKey(key)) {
     return true;
   }
 
@@ -22,7 +31,21 @@ bool Screen::OnKey(TermKeyCode key) {
     return true;
   }
 
+  if (key == 'c' && _CgroupAvailable) {
+    ShowPage(_Page == Page::Processes ? Page::Cgroups : Page::Processes);
+    return true;
+  }
+
   return false;
 }
 
+void Screen::ShowPage(Page page) {
+  _Page = page;
+  _ProcessView->SetVisible(page == Page::Processes);
+  _CgroupView->SetVisible(page == Page::Cgroups);
+  CalculateLayout();
+  // Fill the newly shown page right away instead of on the next tick.
+  _OmniMon.Update();
+}
+
 } // namespace frontend::curses
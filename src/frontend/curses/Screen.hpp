@@ -2,9 +2,12 @@
 
 #include <signal.h>
 
+#include "CgroupView.hpp"
 #include "Events.hpp"
 #include "Options.hpp"
+#include "PressurePane.hpp"
 #include "ProcessTree.hpp"
+#include "SystemPane.hpp"
 #include "layouts/Container.hpp"
 
 namespace frontend::curses {
@@ -13,13 +16,37 @@ class OmniMon;
 
 class Screen : public Container {
 public:
-  explicit Screen(OmniMon& mon, std::shared_ptr<ProcessTree> ps);
+  explicit Screen(OmniMon& mon, std::shared_ptr<SystemPane> system, std::shared_ptr<PressurePane> pressure,
+                  std::shared_ptr<ProcessTree> ps, std::shared_ptr<CgroupView> cgroups);
   ~Screen() override = default;
 
+  enum class Page { Processes, Cgroups };
+  Page GetPage() const { return _Page; }
+
   bool OnKey(TermKeyCode key) override;
 
 private:
+  // Gives the whole screen to the view of one page and nothing to the others.
+  class PageContext : public Container::Context {
+  public:
+    explicit PageContext(const Screen& screen, Page page) : _Screen(screen), _Page(page) {}
+    ~PageContext() override = default;
+
+    ArrangementType GetArrangement() const override { return ArrangementType::FillRest; }
+    DisplayLength GetSize() const override { return _Screen._Page == _Page ? 1 : 0; }
+
+  private:
+    const Screen& _Screen;
+    const Page _Page;
+  };
+
+  void ShowPage(Page page);
+
   OmniMon& _OmniMon;
+  std::shared_ptr<View> _ProcessView;
+  std::shared_ptr<View> _CgroupView;
+  bool _CgroupAvailable;
+  Page _Page = Page::Processes;
 };
 
 } // namespace frontend::curses
@@ -0,0 +1,104 @@
+#include "SystemPane.hpp"
+
+#include <format>
+
+#include "../../backend/metrics/Arithmetic.hpp"
+#include "../../backend/metrics/Counter.hpp"
+#include "../../utils/Formatter.hpp"
+#include "Options.hpp"
+
+namespace frontend::curses {
+
+using namespace backend::system;
+
+SystemPane::SystemPane()
+    : _Container(std::make_shared<Container>(Container::GrowthType::TopDown)),
+      _Summary(std::make_shared<TextView>(TextView::Align::Left)),
+      _CpuLine(std::make_shared<TextView>(TextView::Align::Left)),
+      _IoLine(std::make_shared<TextView>(TextView::Align::Left)) {
+  for (auto& line : {_Summary, _CpuLine, _IoLine}) {
+    _Container->AppendChild(line, std::make_shared<Container::SimpleContext>(Container::ArrangementType::Forward, 1));
+  }
+
+  try {
+    _DiskStats.emplace();
+  } catch (const std::system_error&) {
+    // No block devices to account, e.g. in a container.
+  }
+  try {
+    _NetDev.emplace();
+  } catch (const std::system_error&) {
+    // No network namespace visible, e.g. /proc/net hidden by a sandbox.
+  }
+
+  // Learn the CPUs, and give the rates a starting point.
+  Update();
+  _Cpu = CpuUsage(CpuStat::Total);
+  for (auto& cpu : _CpuStat.GetKeys()) {
+    _Cpus.push_back(CpuUsage(cpu));
+  }
+  if (_DiskStats) {
+    _DiskRead = Rate(_DiskStats->GetGauge(DiskStats::Total, DiskField::ReadBytes));
+    _DiskWrite = Rate(_DiskStats->GetGauge(DiskStats::Total, DiskField::WriteBytes));
+  }
+  if (_NetDev) {
+    _NetReceive = Rate(_NetDev->GetGauge(NetDev::Total, NetField::RxBytes));
+    _NetTransmit = Rate(_NetDev->GetGauge(NetDev::Total, NetField::TxBytes));
+  }
+  Update();
+  Refresh();
+}
+
+SystemPane::GaugePtr SystemPane::CpuUsage(std::string_view cpu) {
+  return std::make_shared<backend::metrics::Ratio>(Rate(_CpuStat.GetGauge(cpu, CpuField::Busy)),
+                                                   Rate(_CpuStat.GetGauge(cpu, CpuField::Total)));
+}
+
+SystemPane::GaugePtr SystemPane::Rate(GaugePtr counter) {
+  return std::make_shared<backend::metrics::CounterSlice>(counter, Config::GetInstance().RefreshInterval);
+}
+
+void SystemPane::Update() {
+  _CpuStat.Update();
+  _MemInfo.Update();
+  _LoadAvg.Update();
+  if (_DiskStats) {
+    _DiskStats->Update();
+  }
+  if (_NetDev) {
+    _NetDev->Update();
+  }
+}
+
+void SystemPane::Refresh() {
+  auto percent = [](const GaugePtr& ratio) { return ratio->GetValue() / 100.0f; };
+  auto load = [this](LoadField field) { return _LoadAvg.GetGauge(field)->GetValue() / 100.0f; };
+  auto memory = [this](MemField field) { return _MemInfo.GetGauge(field)->GetValue(); };
+  auto size = [](backend::metrics::DataType bytes) { return utils::DiskSizeToString(bytes, 5); };
+
+  _Summary->SetText(std::format("CPU {:5.1f}%  Load {:.2f} {:.2f} {:.2f}  Tasks {} running {} blocked {}",
+                                percent(_Cpu), load(LoadField::Load1), load(LoadField::Load5),
+                                load(LoadField::Load15), _LoadAvg.GetGauge(LoadField::Threads)->GetValue(),
+                                _CpuStat.GetRunning()->GetValue(), _CpuStat.GetBlocked()->GetValue()));
+
+  std::string cpus = "CPUs";
+  for (auto& cpu : _Cpus) {
+    cpus += std::format("{:4.0f}", percent(cpu));
+  }
+  _CpuLine->SetText(cpus);
+
+  std::string io = std::format("Mem {}/{} avail {}  Swap {}/{}",
+                               size(memory(MemField::Total) - memory(MemField::Available)),
+                               size(memory(MemField::Total)), size(memory(MemField::Available)),
+                               size(memory(MemField::SwapTotal) - memory(MemField::SwapFree)),
+                               size(memory(MemField::SwapTotal)));
+  if (_DiskStats) {
+    io += std::format("  Disk R {} W {}", size(_DiskRead->GetValue()), size(_DiskWrite->GetValue()));
+  }
+  if (_NetDev) {
+    io += std::format("  Net Rx {} Tx {}", size(_NetReceive->GetValue()), size(_NetTransmit->GetValue()));
+  }
+  _IoLine->SetText(io);
+}
+
+} // namespace frontend::curses
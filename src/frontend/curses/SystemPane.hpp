@@ -0,0 +1,53 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "../../backend/system/CpuStat.hpp"
+#include "../../backend/system/DiskStats.hpp"
+#include "../../backend/system/LoadAvg.hpp"
+#include "../../backend/system/MemInfo.hpp"
+#include "../../backend/system/NetDev.hpp"
+#include "layouts/Container.hpp"
+#include "layouts/TextView.hpp"
+
+namespace frontend::curses {
+
+// The header lines with system wide CPU, memory, disk and network usage. All files are read once per refresh, however
+// many processes are on screen.
+class SystemPane {
+public:
+  explicit SystemPane();
+
+  static constexpr DisplayLength Height = 3;
+
+  std::shared_ptr<View> GetView() const { return _Container; }
+  void Update();
+  // Renders the text, once the rates derived in the refresh have settled, i.e. after its UpdateEpoch.
+  void Refresh();
+
+private:
+  using GaugePtr = std::shared_ptr<backend::metrics::Gauge>;
+
+  GaugePtr CpuUsage(std::string_view cpu);
+  GaugePtr Rate(GaugePtr counter);
+
+  backend::system::CpuStat _CpuStat;
+  backend::system::MemInfo _MemInfo;
+  backend::system::LoadAvg _LoadAvg;
+  // Absent e.g. in containers without /proc/diskstats, that part of the pane is left out then.
+  std::optional<backend::system::DiskStats> _DiskStats;
+  std::optional<backend::system::NetDev> _NetDev;
+
+  GaugePtr _Cpu;
+  std::vector<GaugePtr> _Cpus;
+  GaugePtr _DiskRead, _DiskWrite, _NetReceive, _NetTransmit;
+
+  std::shared_ptr<Container> _Container;
+  std::shared_ptr<TextView> _Summary;
+  std::shared_ptr<TextView> _CpuLine;
+  std::shared_ptr<TextView> _IoLine;
+};
+
+} // namespace frontend::curses
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+
+namespace utils {
+
+// Walks whitespace separated fields of procfs style text in place, without copying or allocating.
+class FieldParser {
+public:
+  explicit FieldParser(std::string_view text) : _Pos(text.data()), _End(text.data() + text.size()) {}
+
+  bool Done() {
+    SkipSpaces();
+    return _Pos == _End;
+  }
+
+  std::string_view Rest() const { return {_Pos, static_cast<size_t>(_End - _Pos)}; }
+
+  template <typename T> bool Next(T& value) {
+    SkipSpaces();
+    auto [ptr, ec] = std::from_chars(_Pos, _End, value);
+    if (ec != std::errc()) {
+      return false;
+    }
+    _Pos = ptr;
+    return true;
+  }
+
+  bool Next(char& value) {
+    SkipSpaces();
+    if (_Pos == _End) {
+      return false;
+    }
+    value = *_Pos++;
+    return true;
+  }
+
+  bool Next(std::string_view& word) {
+    SkipSpaces();
+    const char* begin = _Pos;
+    while (_Pos != _End && !IsSpace(*_Pos)) {
+      ++_Pos;
+    }
+    word = {begin, static_cast<size_t>(_Pos - begin)};
+    return !word.empty();
+  }
+
+  // A fixed point number like the "12.34" of loadavg or PSI, as 1234. Further digits are dropped.
+  bool NextHundredths(uint64_t& value) {
+    uint64_t whole;
+    if (!Next(whole)) {
+      return false;
+    }
+    uint64_t fraction = 0;
+    int digits = 0;
+    if (_Pos != _End && *_Pos == '.') {
+      for (++_Pos; _Pos != _End && *_Pos >= '0' && *_Pos <= '9'; ++_Pos) {
+        if (digits < 2) {
+          fraction = fraction * 10 + (*_Pos - '0');
+          ++digits;
+        }
+      }
+    }
+    for (; digits < 2; ++digits) {
+      fraction *= 10;
+    }
+    value = whole * 100 + fraction;
+    return true;
+  }
+
+  template <typename... Ts> bool NextAll(Ts&... values) { return (Next(values) && ...); }
+
+  bool Skip(size_t count = 1) {
+    std::string_view word;
+    for (size_t i = 0; i < count; ++i) {
+      if (!Next(word)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Advance to the first character after the next occurrence of `c` in the current line.
+  bool SkipPast(char c) {
+    while (_Pos != _End && *_Pos != c && *_Pos != '\n') {
+      ++_Pos;
+    }
+    if (_Pos == _End || *_Pos != c) {
+      return false;
+    }
+    ++_Pos;
+    return true;
+  }
+
+  // Advance to the beginning of the next line.
+  bool NextLine() {
+    while (_Pos != _End && *_Pos++ != '\n') {
+    }
+    return _Pos != _End;
+  }
+
+private:
+  static bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\n'; }
+
+  void SkipSpaces() {
+    while (_Pos != _End && IsSpace(*_Pos)) {
+      ++_Pos;
+    }
+  }
+
+  const char* _Pos;
+  const char* _End;
+};
+
+} // namespace utils
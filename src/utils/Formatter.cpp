@@ -1,6 +1,7 @@
 #include "Formatter.hpp"
 
 #include <format>
+#include <string_view>
 
 namespace utils {
 
@@ -18,4 +19,24 @@ std::string DiskSizeToString(uint64_t size, DisplayLength width) {
   }
 }
 
+std::string CountToString(uint64_t count, DisplayLength width) {
+  uint64_t limit = 1;
+  for (DisplayLength i = 0; i < width; ++i) {
+    limit *= 10;
+  }
+  if (count < limit) {
+    return std::format("{:>{}d}", count, width);
+  }
+
+  // Truncated rather than rounded, so the mantissa never grows past the width-1 digits left by the suffix.
+  limit /= 10;
+  for (char suffix : std::string_view("kMGTP")) {
+    count /= 1000;
+    if (count < limit) {
+      return std::format("{:>{}d}{}", count, width - 1, suffix);
+    }
+  }
+  return std::format("{:>{}d}E", count / 1000, width - 1);
+}
+
 } // namespace utils
@@ -7,5 +7,6 @@
 namespace utils {
 
 std::string DiskSizeToString(uint64_t size, DisplayLength width);
+std::string CountToString(uint64_t count, DisplayLength width);
 
 } // namespace utils
@@ -0,0 +1,65 @@
+#include "Pool.hpp"
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+namespace utils {
+
+namespace {
+
+std::vector<Pool*>& GetPools() {
+  static auto* pools = new std::vector<Pool*>();
+  return *pools;
+}
+
+} // namespace
+
+Pool::Pool(size_t size, size_t align)
+    : _Align(std::max(align, alignof(FreeBlock))),
+      _Size((std::max(size, sizeof(FreeBlock)) + _Align - 1) / _Align * _Align) {
+  GetPools().push_back(this);
+}
+
+Pool::Stats Pool::GetTotalStats() {
+  Stats total;
+  for (auto* pool : GetPools()) {
+    total.Allocations += pool->_Stats.Allocations;
+    total.Chunks += pool->_Stats.Chunks;
+    total.Live += pool->_Stats.Live;
+  }
+  return total;
+}
+
+void* Pool::Allocate() {
+  if (!_Free) {
+    Grow();
+  }
+  FreeBlock* block = _Free;
+  _Free = block->Next;
+  ++_Stats.Allocations;
+  ++_Stats.Live;
+  return block;
+}
+
+void Pool::Deallocate(void* block) {
+  auto* free = static_cast<FreeBlock*>(block);
+  free->Next = _Free;
+  _Free = free;
+  --_Stats.Live;
+}
+
+void Pool::Grow() {
+  size_t count = std::max<size_t>(ChunkBytes / _Size, 1);
+  auto* chunk = static_cast<char*>(::operator new(count * _Size, std::align_val_t(_Align)));
+  ++_Stats.Chunks;
+
+  // Thread the free list through the new blocks, lowest address first.
+  for (size_t i = count; i > 0; --i) {
+    auto* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * _Size);
+    block->Next = _Free;
+    _Free = block;
+  }
+}
+
+} // namespace utils
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace utils {
+
+// Fixed-size blocks carved out of larger chunks and recycled through a free list, for objects created and dropped in
+// large numbers, e.g. the processes and the metrics bound to the rows on every refresh. Chunks are kept for the life
+// of the program. Not thread-safe: pooled objects must be created and destroyed on the UI thread.
+class Pool {
+public:
+  struct Stats {
+    // Blocks handed out, i.e. what would have been a heap allocation each.
+    uint64_t Allocations = 0;
+    // Chunks taken from the heap to serve them.
+    uint64_t Chunks = 0;
+    uint64_t Live = 0;
+  };
+
+  // One pool per block size and alignment, shared by every type of that size. Never destroyed, since pooled objects
+  // may be dropped during static destruction.
+  template <size_t Size, size_t Align> static Pool& ForSize() {
+    static Pool* pool = new Pool(Size, Align);
+    return *pool;
+  }
+
+  // Summed over all pools.
+  static Stats GetTotalStats();
+  const Stats& GetStats() const { return _Stats; }
+
+  void* Allocate();
+  void Deallocate(void* block);
+
+private:
+  explicit Pool(size_t size, size_t align);
+  ~Pool() = default;
+
+  // Small enough that a pool of a rarely used size wastes little.
+  static constexpr size_t ChunkBytes = 16 * 1024;
+
+  struct FreeBlock {
+    FreeBlock* Next;
+  };
+
+  void Grow();
+
+  const size_t _Align;
+  const size_t _Size;
+  FreeBlock* _Free = nullptr;
+  Stats _Stats;
+};
+
+// Allocates single objects from the Pool of their size, anything else from the heap. Stateless, so it rebinds freely,
+// e.g. to the control block of std::allocate_shared.
+template <typename T> class PoolAllocator {
+public:
+  using value_type = T;
+
+  PoolAllocator() = default;
+  template <typename U> PoolAllocator(const PoolAllocator<U>&) {}
+
+  T* allocate(size_t n) {
+    if (n != 1) {
+      return std::allocator<T>().allocate(n);
+    }
+    return static_cast<T*>(Pool::ForSize<sizeof(T), alignof(T)>().Allocate());
+  }
+  void deallocate(T* p, size_t n) {
+    if (n != 1) {
+      std::allocator<T>().deallocate(p, n);
+      return;
+    }
+    Pool::ForSize<sizeof(T), alignof(T)>().Deallocate(p);
+  }
+
+  template <typename U> bool operator==(const PoolAllocator<U>&) const { return true; }
+};
+
+// std::make_shared with the object and its control block in one pooled block.
+template <typename T, typename... Args> std::shared_ptr<T> MakePooled(Args&&... args) {
+  return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+} // namespace utils
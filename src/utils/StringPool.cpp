@@ -0,0 +1,37 @@
+#include "StringPool.hpp"
+
+namespace utils {
+
+StringPool& StringPool::GetInstance() {
+  // Never destroyed: handles may outlive static destruction, e.g. in other singletons.
+  static StringPool* instance = new StringPool();
+  return *instance;
+}
+
+StringPool::Handle StringPool::Intern(std::string_view text) {
+  std::lock_guard lock(_Lock);
+  if (auto it = _Strings.find(text); it != _Strings.end()) {
+    if (auto handle = it->second.lock()) {
+      return handle;
+    }
+    // The last handle is on its way out, Release won't touch the new entry.
+    _Strings.erase(it);
+  }
+
+  auto* copy = new std::string(text);
+  Handle handle(copy, [this](const std::string* text) { Release(text); });
+  _Strings.emplace(*copy, handle);
+  return handle;
+}
+
+void StringPool::Release(const std::string* text) {
+  {
+    std::lock_guard lock(_Lock);
+    if (auto it = _Strings.find(*text); it != _Strings.end() && it->first.data() == text->data()) {
+      _Strings.erase(it);
+    }
+  }
+  delete text;
+}
+
+} // namespace utils
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace utils {
+
+// Interns immutable strings: equal strings share one copy, which is freed with its last handle. Meant for values
+// repeated across many objects, like the command lines of a thousand identical workers.
+class StringPool {
+public:
+  using Handle = std::shared_ptr<const std::string>;
+
+  static StringPool& GetInstance();
+
+  Handle Intern(std::string_view text);
+
+private:
+  explicit StringPool() = default;
+  ~StringPool() = default;
+
+  void Release(const std::string* text);
+
+  std::mutex _Lock;
+  // Keys point into the strings themselves; an entry is removed before its string is freed.
+  std::unordered_map<std::string_view, std::weak_ptr<const std::string>> _Strings;
+};
+
+} // namespace utils
@@ -0,0 +1,156 @@
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+
+namespace utils {
+
+WorkerPool::WorkerPool(size_t threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  for (size_t i = 0; i < threads; ++i) {
+    _Shards.push_back(std::make_unique<Shard>());
+  }
+
+  // Shard 0 belongs to the thread calling Run.
+  for (size_t i = 1; i < threads; ++i) {
+    _Threads.emplace_back(&WorkerPool::Worker, this, i);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard lock(_Lock);
+    _Stop = true;
+  }
+  _Start.notify_all();
+  for (auto& thread : _Threads) {
+    thread.join();
+  }
+}
+
+void WorkerPool::Run(size_t count, const std::function<void(size_t)>& work) {
+  if (count == 0) {
+    return;
+  }
+
+  // Too little to be worth waking anyone up.
+  if (_Threads.empty() || count <= Chunk) {
+    for (size_t i = 0; i < count; ++i) {
+      work(i);
+    }
+    return;
+  }
+
+  size_t shards = _Shards.size();
+  for (size_t i = 0; i < shards; ++i) {
+    std::lock_guard lock(_Shards[i]->Lock);
+    _Shards[i]->Begin = count * i / shards;
+    _Shards[i]->End = count * (i + 1) / shards;
+  }
+
+  {
+    std::lock_guard lock(_Lock);
+    _Work = &work;
+    _Running = _Threads.size();
+    ++_Generation;
+  }
+  _Start.notify_all();
+
+  Drain(0);
+
+  std::unique_lock lock(_Lock);
+  _Done.wait(lock, [this] { return _Running == 0; });
+  _Work = nullptr;
+}
+
+bool WorkerPool::TakeOwn(Shard& shard, size_t& begin, size_t& end) {
+  std::lock_guard lock(shard.Lock);
+  if (shard.Begin == shard.End) {
+    return false;
+  }
+  begin = shard.Begin;
+  end = std::min(shard.End, begin + Chunk);
+  shard.Begin = end;
+  return true;
+}
+
+bool WorkerPool::Steal(size_t self, size_t& begin, size_t& end) {
+  while (true) {
+    Shard* victim = nullptr;
+    size_t most = 0;
+    for (size_t i = 0; i < _Shards.size(); ++i) {
+      if (i == self) {
+        continue;
+      }
+      std::lock_guard lock(_Shards[i]->Lock);
+      if (size_t size = _Shards[i]->End - _Shards[i]->Begin; size > most) {
+        most = size;
+        victim = _Shards[i].get();
+      }
+    }
+
+    if (!victim) {
+      return false;
+    }
+
+    std::lock_guard lock(victim->Lock);
+    size_t size = victim->End - victim->Begin;
+    if (size == 0) {
+      // Drained while we were looking, pick another one.
+      continue;
+    }
+    // Leave the victim the front half it is about to work on.
+    begin = victim->End - (size + 1) / 2;
+    end = victim->End;
+    victim->End = begin;
+    return true;
+  }
+}
+
+void WorkerPool::Drain(size_t self) {
+  auto& own = *_Shards[self];
+  const auto& work = *_Work;
+  size_t begin, end;
+  while (true) {
+    if (!TakeOwn(own, begin, end)) {
+      if (!Steal(self, begin, end)) {
+        return;
+      }
+      // Move the stolen range into our own shard so others can steal from it in turn.
+      std::lock_guard lock(own.Lock);
+      own.Begin = begin;
+      own.End = end;
+      continue;
+    }
+
+    for (size_t i = begin; i < end; ++i) {
+      work(i);
+    }
+  }
+}
+
+void WorkerPool::Worker(size_t self) {
+  size_t generation = 0;
+  while (true) {
+    {
+      std::unique_lock lock(_Lock);
+      _Start.wait(lock, [&] { return _Stop || _Generation != generation; });
+      if (_Stop) {
+        return;
+      }
+      generation = _Generation;
+    }
+
+    Drain(self);
+
+    {
+      std::lock_guard lock(_Lock);
+      --_Running;
+    }
+    _Done.notify_one();
+  }
+}
+
+} // namespace utils
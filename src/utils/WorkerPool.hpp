@@ -0,0 +1,59 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+
+// A fixed set of threads running index ranges in parallel. The range is split into one shard per thread; a thread
+// that finishes its own shard steals the back half of the largest remaining one, so a few slow items don't hold up the
+// whole run.
+class WorkerPool {
+public:
+  // `threads` includes the calling thread, which takes part in every Run. 0 means one per online CPU.
+  explicit WorkerPool(size_t threads = 0);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool(WorkerPool&&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+  WorkerPool& operator=(WorkerPool&&) = delete;
+
+  size_t GetThreads() const { return _Shards.size(); }
+
+  // Calls `work(i)` for every i in [0, count) and returns when all calls are done. Not reentrant.
+  void Run(size_t count, const std::function<void(size_t)>& work);
+
+private:
+  struct alignas(64) Shard {
+    std::mutex Lock;
+    size_t Begin = 0;
+    size_t End = 0;
+  };
+
+  bool TakeOwn(Shard& shard, size_t& begin, size_t& end);
+  bool Steal(size_t self, size_t& begin, size_t& end);
+  void Drain(size_t self);
+  void Worker(size_t self);
+
+  // Items taken from a shard at once, to keep the shard lock off the per item path.
+  static constexpr size_t Chunk = 16;
+
+  std::vector<std::unique_ptr<Shard>> _Shards;
+  std::vector<std::thread> _Threads;
+
+  std::mutex _Lock;
+  std::condition_variable _Start;
+  std::condition_variable _Done;
+  const std::function<void(size_t)>* _Work = nullptr;
+  size_t _Generation = 0;
+  size_t _Running = 0;
+  bool _Stop = false;
+};
+
+} // namespace utils